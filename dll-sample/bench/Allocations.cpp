@@ -0,0 +1,113 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#include "Bench.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#    include <malloc.h>
+#endif
+
+namespace {
+
+std::atomic<std::size_t> allocationCount{};
+
+void *allocate(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (auto *pointer = std::malloc(size == 0 ? 1 : size); pointer != nullptr) {
+        return pointer;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void *allocate(std::size_t size, std::align_val_t alignment) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    auto align = static_cast<std::size_t>(alignment);
+    // aligned_alloc requires the size to be a multiple of the alignment.
+    auto alignedSize = (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+
+#ifdef _WIN32
+    if (auto *pointer = _aligned_malloc(alignedSize, align); pointer != nullptr) {
+#else
+    if (auto *pointer = std::aligned_alloc(align, alignedSize); pointer != nullptr) {
+#endif
+        return pointer;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void deallocate(void *pointer, std::align_val_t) noexcept {
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+} // namespace
+
+// The replaced global allocation functions count the allocations of the whole process. The nothrow versions are
+// implemented by the standard library through these ones.
+void *operator new(std::size_t size) {
+    return allocate(size);
+}
+
+void *operator new[](std::size_t size) {
+    return allocate(size);
+}
+
+void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    return allocate(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocate(size, alignment);
+}
+
+void operator delete(void *pointer, std::align_val_t alignment) noexcept {
+    deallocate(pointer, alignment);
+}
+
+void operator delete[](void *pointer, std::align_val_t alignment) noexcept {
+    deallocate(pointer, alignment);
+}
+
+void operator delete(void *pointer, std::size_t, std::align_val_t alignment) noexcept {
+    deallocate(pointer, alignment);
+}
+
+void operator delete[](void *pointer, std::size_t, std::align_val_t alignment) noexcept {
+    deallocate(pointer, alignment);
+}
+
+namespace dsp::bench {
+
+std::size_t getAllocationCount() noexcept {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+} // namespace dsp::bench
@@ -0,0 +1,282 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace dsp::bench {
+
+/**
+ * Makes the value observable, so the compiler cannot optimize away the computation that produced it.
+ *
+ * @param value The value
+ */
+template <typename T> void doNotOptimize(const T &value) noexcept {
+#if defined(__GNUC__)
+    // The empty assembly "reads" the value, so the value has to be computed, but nothing is stored.
+    if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(long long)) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    } else {
+        asm volatile("" : : "m"(value) : "memory");
+    }
+#else
+    static volatile T sink{};
+
+    sink = value;
+    static_cast<void>(sink);
+#endif
+}
+
+/**
+ * The command line options of the benchmarks.
+ */
+struct Options {
+    /// The number of events in a batch (the scenarios that take it).
+    std::size_t batchSize = 1024;
+    /// The number of symbols (the scenarios that take it).
+    std::size_t symbols = 1000;
+    /// The number of the dispatch threads of the plugin pipeline.
+    std::size_t dispatchThreads = 0;
+    /// `true` if the results are printed as JSON lines instead of the table.
+    bool json = false;
+};
+
+/**
+ * @return The options of the run.
+ */
+Options &getOptions() noexcept;
+
+/**
+ * @return The number of heap allocations made by the process so far (counted by the replaced global `operator new`).
+ */
+std::size_t getAllocationCount() noexcept;
+
+/**
+ * The result of one benchmark case.
+ */
+struct Result {
+    std::string name;
+    std::size_t iterations;
+    std::size_t items;
+    double nsPerItem;
+    double itemsPerSecond;
+};
+
+/**
+ * Runs the iteration repeatedly (after a short warm-up) for at least the specified duration and measures the time
+ * spent per processed item.
+ *
+ * @param name The case name
+ * @param itemsPerIteration The number of items (events, symbols, etc.) one iteration processes
+ * @param iteration The iteration
+ * @param duration The minimal measurement duration
+ * @return The result
+ */
+template <typename Iteration>
+Result measure(std::string name, std::size_t itemsPerIteration, Iteration &&iteration,
+               std::chrono::nanoseconds duration = std::chrono::milliseconds(300)) {
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t WARM_UP_ITERATIONS = 16;
+    static constexpr std::size_t ITERATIONS_PER_CLOCK_CHECK = 16;
+
+    for (std::size_t i = 0; i < WARM_UP_ITERATIONS; i++) {
+        iteration();
+    }
+
+    std::size_t iterations = 0;
+    auto start = Clock::now();
+    auto now = start;
+
+    do {
+        for (std::size_t i = 0; i < ITERATIONS_PER_CLOCK_CHECK; i++) {
+            iteration();
+        }
+
+        iterations += ITERATIONS_PER_CLOCK_CHECK;
+        now = Clock::now();
+    } while (now - start < duration);
+
+    auto ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count());
+    auto items = iterations * itemsPerIteration;
+
+    return {std::move(name), iterations, items, ns / static_cast<double>(items),
+            static_cast<double>(items) * 1e9 / ns};
+}
+
+/**
+ * Runs the iteration by several threads concurrently for the specified duration and measures the throughput of all of
+ * them.
+ *
+ * @param name The case name
+ * @param threads The number of threads
+ * @param itemsPerIteration The number of items one iteration processes
+ * @param iteration The iteration (called concurrently)
+ * @param duration The measurement duration
+ * @return The result
+ */
+template <typename Iteration>
+Result measureConcurrently(std::string name, std::size_t threads, std::size_t itemsPerIteration, Iteration &&iteration,
+                           std::chrono::nanoseconds duration = std::chrono::milliseconds(300)) {
+    using Clock = std::chrono::steady_clock;
+
+    std::atomic<bool> running{true};
+    std::atomic<std::size_t> iterations{};
+    std::vector<std::thread> workers{};
+    auto start = Clock::now();
+
+    for (std::size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&] {
+            std::size_t done = 0;
+
+            while (running.load(std::memory_order_relaxed)) {
+                iteration();
+                done++;
+            }
+
+            iterations.fetch_add(done);
+        });
+    }
+
+    std::this_thread::sleep_for(duration);
+    running = false;
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    auto ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    auto items = iterations.load() * itemsPerIteration;
+
+    return {std::move(name), iterations.load(), items, ns / static_cast<double>(items),
+            static_cast<double>(items) * 1e9 / ns};
+}
+
+/**
+ * Prints the result.
+ *
+ * @param result The result
+ */
+inline void report(const Result &result) {
+    if (getOptions().json) {
+        std::printf("{\"name\":\"%s\",\"iterations\":%zu,\"items\":%zu,\"ns_per_item\":%.3f,"
+                    "\"items_per_second\":%.0f}\n",
+                    result.name.c_str(), result.iterations, result.items, result.nsPerItem, result.itemsPerSecond);
+
+        return;
+    }
+
+    std::printf("%-48s %12.3f ns/item %16.0f items/s\n", result.name.c_str(), result.nsPerItem, result.itemsPerSecond);
+}
+
+/**
+ * The result of one benchmark case measured batch by batch.
+ */
+struct BatchResult {
+    Result result;
+    double allocationsPerItem;
+    double p50Ns;
+    double p99Ns;
+};
+
+/**
+ * Runs the iteration (one batch) repeatedly (after a short warm-up) for at least the specified duration, measures the
+ * time of every iteration and counts the heap allocations.
+ *
+ * @param name The case name
+ * @param itemsPerIteration The number of items (events) one iteration processes
+ * @param iteration The iteration
+ * @param duration The minimal measurement duration
+ * @return The result with the batch latency percentiles.
+ */
+template <typename Iteration>
+BatchResult measureBatches(std::string name, std::size_t itemsPerIteration, Iteration &&iteration,
+                           std::chrono::nanoseconds duration = std::chrono::milliseconds(300)) {
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t WARM_UP_ITERATIONS = 16;
+    static constexpr std::size_t MAX_SAMPLES = std::size_t{1} << 20;
+
+    for (std::size_t i = 0; i < WARM_UP_ITERATIONS; i++) {
+        iteration();
+    }
+
+    // Allocated before the counting starts.
+    std::vector<double> samples(MAX_SAMPLES);
+    std::size_t iterations = 0;
+    auto allocations = getAllocationCount();
+    auto start = Clock::now();
+    auto now = start;
+
+    do {
+        auto before = now;
+
+        iteration();
+        now = Clock::now();
+        samples[iterations++] =
+            static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - before).count());
+    } while (now - start < duration && iterations < MAX_SAMPLES);
+
+    allocations = getAllocationCount() - allocations;
+
+    auto ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count());
+    auto items = iterations * itemsPerIteration;
+    auto percentile = [&samples, iterations](double p) {
+        auto rank = std::min(iterations - 1, static_cast<std::size_t>(p * static_cast<double>(iterations)));
+
+        std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(rank),
+                         samples.begin() + static_cast<std::ptrdiff_t>(iterations));
+
+        return samples[rank];
+    };
+
+    auto result = Result{std::move(name), iterations, items, ns / static_cast<double>(items),
+                         static_cast<double>(items) * 1e9 / ns};
+
+    return {std::move(result), static_cast<double>(allocations) / static_cast<double>(items), percentile(0.5),
+            percentile(0.99)};
+}
+
+/**
+ * Prints the result with the allocation rate and the batch latency percentiles.
+ *
+ * @param result The result
+ */
+inline void report(const BatchResult &result) {
+    if (getOptions().json) {
+        std::printf("{\"name\":\"%s\",\"iterations\":%zu,\"items\":%zu,\"ns_per_item\":%.3f,\"items_per_second\":%.0f,"
+                    "\"allocations_per_item\":%.3f,\"p50_ns\":%.0f,\"p99_ns\":%.0f}\n",
+                    result.result.name.c_str(), result.result.iterations, result.result.items, result.result.nsPerItem,
+                    result.result.itemsPerSecond, result.allocationsPerItem, result.p50Ns, result.p99Ns);
+
+        return;
+    }
+
+    std::printf("%-48s %12.3f ns/item %16.0f items/s %8.3f allocs/item %12.0f ns p50 %12.0f ns p99\n",
+                result.result.name.c_str(), result.result.nsPerItem, result.result.itemsPerSecond,
+                result.allocationsPerItem, result.p50Ns, result.p99Ns);
+}
+
+void runColumnsBench();
+void runRoutingBench();
+void runQueueBench();
+void runHandlerBench();
+void runMaterializeBench();
+void runDecodeBench();
+void runRegistryBench();
+void runSymbolListBench();
+void runProbeBench();
+void runPipelineBench();
+void runReplayBench();
+
+} // namespace dsp::bench
@@ -0,0 +1,104 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#include "Bench.hpp"
+
+#include <plugin-api.h>
+
+#include "EventArena.hpp"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace dsp::bench {
+
+namespace {
+
+constexpr std::size_t BATCH_SIZE = 1024;
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+// The spread/mid kernel over the columns. The loop has no branches and no aliasing, so the compiler vectorizes it.
+void spreadMid(std::size_t count, const double *__restrict bidPrice, const double *__restrict askPrice,
+               double *__restrict spread, double *__restrict mid) noexcept {
+    for (std::size_t i = 0; i < count; i++) {
+        spread[i] = askPrice[i] - bidPrice[i];
+        mid[i] = (askPrice[i] + bidPrice[i]) * 0.5;
+    }
+}
+
+// The same kernel over the pointer-per-event batch delivered by dsp_subscribe.
+void spreadMid(dsp_event_t *const *events, std::size_t size, double *spread, double *mid) noexcept {
+    for (std::size_t i = 0; i < size; i++) {
+        if (events[i]->type != DSP_ET_QUOTE) {
+            continue;
+        }
+
+        const auto *q = reinterpret_cast<const dsp_quote_t *>(events[i]);
+
+        spread[i] = q->ask_price - q->bid_price;
+        mid[i] = (q->ask_price + q->bid_price) * 0.5;
+    }
+}
+
+// The same kernel over the contiguous records delivered by dsp_subscribe_records.
+void spreadMid(const dsp_event_record_t *records, std::size_t size, double *spread, double *mid) noexcept {
+    for (std::size_t i = 0; i < size; i++) {
+        if (records[i].event.type != DSP_ET_QUOTE) {
+            continue;
+        }
+
+        spread[i] = records[i].quote.ask_price - records[i].quote.bid_price;
+        mid[i] = (records[i].quote.ask_price + records[i].quote.bid_price) * 0.5;
+    }
+}
+
+} // namespace
+
+void runColumnsBench() {
+    std::mt19937_64 random{42};
+    std::uniform_real_distribution<double> prices{100.0, 200.0};
+    std::uniform_real_distribution<double> sizes{1.0, 1000.0};
+
+    std::vector<std::unique_ptr<dsp_quote_t>> quotes{};
+    std::vector<dsp_event_t *> events{};
+    std::vector<dsp_event_record_t> records(BATCH_SIZE);
+
+    EventArena arena{};
+
+    arena.reset(4 * EventArena::bytesFor<double, CACHE_LINE_SIZE>(BATCH_SIZE));
+
+    auto *bidPrice = arena.allocateArray<double, CACHE_LINE_SIZE>(BATCH_SIZE);
+    auto *askPrice = arena.allocateArray<double, CACHE_LINE_SIZE>(BATCH_SIZE);
+    auto *spread = arena.allocateArray<double, CACHE_LINE_SIZE>(BATCH_SIZE);
+    auto *mid = arena.allocateArray<double, CACHE_LINE_SIZE>(BATCH_SIZE);
+
+    for (std::size_t i = 0; i < BATCH_SIZE; i++) {
+        auto bid = prices(random);
+        auto ask = bid + 0.01 * (1 + static_cast<double>(i % 10));
+        auto q = dsp_quote_t{{sizeof(dsp_quote_t), DSP_ET_QUOTE, 0, 0}, bid, sizes(random), ask, sizes(random)};
+
+        quotes.emplace_back(std::make_unique<dsp_quote_t>(q));
+        events.emplace_back(&quotes.back()->event);
+        records[i].quote = q;
+        bidPrice[i] = bid;
+        askPrice[i] = ask;
+    }
+
+    report(measure("columns/spread-mid/pointer-per-event", BATCH_SIZE, [&] {
+        spreadMid(events.data(), events.size(), spread, mid);
+        doNotOptimize(mid[BATCH_SIZE - 1]);
+    }));
+
+    report(measure("columns/spread-mid/records", BATCH_SIZE, [&] {
+        spreadMid(records.data(), records.size(), spread, mid);
+        doNotOptimize(mid[BATCH_SIZE - 1]);
+    }));
+
+    report(measure("columns/spread-mid/columns", BATCH_SIZE, [&] {
+        spreadMid(BATCH_SIZE, bidPrice, askPrice, spread, mid);
+        doNotOptimize(mid[BATCH_SIZE - 1]);
+    }));
+}
+
+} // namespace dsp::bench
@@ -0,0 +1,66 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+
+namespace dsp::bench {
+
+/**
+ * The pool of event objects recycled across batches: instead of a heap allocation (and a control block) per event,
+ * the objects of a batch are taken from the pool and the whole pool is recycled when the batch is processed.
+ *
+ * Only the materialization bench uses it, as the model of the pooled alternative: the plugin can't, the events are
+ * materialized by the SDK (one `std::shared_ptr` per event) before the plugin's listener sees them.
+ *
+ * The objects are borrowed: the references returned by EventPool::acquire() stay valid until EventPool::recycle(), so
+ * the listeners may use them during the callback, but must copy what they keep. The recycled objects keep their
+ * members (e.g. the capacity of the strings), so filling them again does not allocate. The objects are never moved.
+ *
+ * @tparam T The event type (default constructible)
+ */
+template <typename T> class EventPool final {
+    std::deque<T> objects_{};
+    std::size_t used_{};
+
+  public:
+    EventPool() = default;
+    EventPool(const EventPool &) = delete;
+    EventPool &operator=(const EventPool &) = delete;
+
+    /**
+     * @return The next free object (its previous contents are left as is, the caller overwrites them).
+     */
+    T &acquire() {
+        if (used_ == objects_.size()) {
+            objects_.emplace_back();
+        }
+
+        return objects_[used_++];
+    }
+
+    /**
+     * Makes all the objects free again. The references returned by EventPool::acquire() are reused.
+     */
+    void recycle() noexcept {
+        used_ = 0;
+    }
+
+    /**
+     * @return The number of the acquired objects.
+     */
+    std::size_t size() const noexcept {
+        return used_;
+    }
+
+    /**
+     * @return The number of the objects owned by the pool.
+     */
+    std::size_t capacity() const noexcept {
+        return objects_.size();
+    }
+};
+
+} // namespace dsp::bench
@@ -0,0 +1,73 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#include "Bench.hpp"
+
+#include "Executor.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+
+namespace dsp::bench {
+
+namespace {
+
+constexpr std::size_t BATCHES = 1024;
+
+// The listener call: counts the handled batches.
+struct CountTask {
+    std::atomic<std::uint64_t> *handled{};
+
+    void operator()() const {
+        handled->fetch_add(1, std::memory_order_release);
+        handled->notify_one();
+    }
+};
+
+void waitFor(const std::atomic<std::uint64_t> &handled, std::uint64_t expected) {
+    for (auto current = handled.load(std::memory_order_acquire); current < expected;
+         current = handled.load(std::memory_order_acquire)) {
+        handled.wait(current, std::memory_order_acquire);
+    }
+}
+
+} // namespace
+
+// The hand-off of a batch to the listeners: the SDK's Handler (a new std::async thread per batch, waited for) against
+// the persistent executor (inline, or a worker thread fed by a lock-free queue).
+void runHandlerBench() {
+    std::atomic<std::uint64_t> handled{};
+    auto task = CountTask{&handled};
+
+    report(measure("handler/std-async/latency", 1, [&] {
+        std::async(std::launch::async, task).wait();
+    }));
+
+    Executor<CountTask> inlineExecutor{0};
+
+    report(measure("handler/executor-inline/latency", 1, [&] {
+        inlineExecutor.execute(0, task);
+    }));
+
+    Executor<CountTask> executor{1};
+
+    report(measure("handler/executor-1-thread/latency", 1, [&] {
+        auto expected = handled.load(std::memory_order_relaxed) + 1;
+
+        executor.execute(0, task);
+        waitFor(handled, expected);
+    }));
+
+    report(measure("handler/executor-1-thread/throughput", BATCHES, [&] {
+        auto expected = handled.load(std::memory_order_relaxed) + BATCHES;
+
+        for (std::size_t i = 0; i < BATCHES; i++) {
+            executor.execute(0, task);
+        }
+
+        waitFor(handled, expected);
+    }));
+}
+
+} // namespace dsp::bench
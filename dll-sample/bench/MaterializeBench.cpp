@@ -0,0 +1,205 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#include "Bench.hpp"
+
+#include <plugin-api.h>
+
+#include "EventBatch.hpp"
+#include "EventPool.hpp"
+#include "SymbolTable.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace dsp::bench {
+
+namespace {
+
+constexpr std::size_t BATCH_SIZE = 1024;
+constexpr std::size_t SYMBOLS = 1000;
+
+// The shape of an event object of the C++ API: a polymorphic object with the symbol and the fields.
+struct QuoteObject {
+    virtual ~QuoteObject() = default;
+
+    std::string eventSymbol{};
+    std::int64_t time{};
+    double bidPrice{};
+    double bidSize{};
+    double askPrice{};
+    double askSize{};
+};
+
+void fill(QuoteObject &quote, const std::string &symbol, std::size_t i) {
+    quote.eventSymbol = symbol;
+    quote.time = static_cast<std::int64_t>(i);
+    quote.bidPrice = 100.0;
+    quote.bidSize = 1.0;
+    quote.askPrice = 100.01;
+    quote.askSize = 1.0;
+}
+
+// Copies the fields out as the feed thread of the plugin does.
+void marshal(const QuoteObject &quote, std::uint32_t symbolId, dsp_event_record_t &record) noexcept {
+    record.quote = dsp_quote_t{{sizeof(dsp_quote_t), DSP_ET_QUOTE, symbolId, 0},
+                               quote.bidPrice,
+                               quote.bidSize,
+                               quote.askPrice,
+                               quote.askSize};
+}
+
+void run(const char *kind, const std::vector<std::string> &names) {
+    SymbolTable symbols{};
+    EventBatch batch{};
+
+    for (const auto &name : names) {
+        symbols.intern(name);
+    }
+
+    std::size_t next = 0;
+
+    // The events are materialized as a shared_ptr (an allocation and a control block) per event and dropped after the
+    // batch.
+    report(measureBatches(std::string{"materialize/shared-ptr/"} + kind, BATCH_SIZE, [&] {
+        std::vector<std::shared_ptr<QuoteObject>> events{};
+
+        events.reserve(BATCH_SIZE);
+
+        for (std::size_t i = 0; i < BATCH_SIZE; i++) {
+            auto quote = std::make_shared<QuoteObject>();
+
+            fill(*quote, names[next++ % names.size()], i);
+            events.push_back(std::move(quote));
+        }
+
+        auto *records = batch.allocate(events.size());
+
+        for (std::size_t i = 0; i < events.size(); i++) {
+            marshal(*events[i], symbols.intern(events[i]->eventSymbol), records[i]);
+        }
+
+        doNotOptimize(records[0].event.symbol_id);
+    }));
+
+    EventPool<QuoteObject> pool{};
+    std::vector<const QuoteObject *> events{};
+
+    events.reserve(BATCH_SIZE);
+
+    // The events are borrowed from the pool and recycled after the batch.
+    report(measureBatches(std::string{"materialize/pooled/"} + kind, BATCH_SIZE, [&] {
+        for (std::size_t i = 0; i < BATCH_SIZE; i++) {
+            auto &quote = pool.acquire();
+
+            fill(quote, names[next++ % names.size()], i);
+            events.push_back(&quote);
+        }
+
+        auto *records = batch.allocate(events.size());
+
+        for (std::size_t i = 0; i < events.size(); i++) {
+            marshal(*events[i], symbols.intern(events[i]->eventSymbol), records[i]);
+        }
+
+        doNotOptimize(records[0].event.symbol_id);
+        events.clear();
+        pool.recycle();
+    }));
+}
+
+using Recording = std::vector<std::vector<std::shared_ptr<QuoteObject>>>;
+
+// Records the batches of events: the symbols of the events come in runs of the specified length.
+Recording record(const std::vector<std::string> &names, std::size_t runLength) {
+    static constexpr std::size_t BATCHES = 64;
+
+    std::mt19937_64 random{42};
+    std::uniform_int_distribution<std::size_t> symbols{0, names.size() - 1};
+    Recording recording(BATCHES);
+    std::size_t symbol = 0;
+
+    for (auto &events : recording) {
+        for (std::size_t i = 0; i < BATCH_SIZE; i++) {
+            if (i % runLength == 0) {
+                symbol = symbols(random);
+            }
+
+            auto quote = std::make_shared<QuoteObject>();
+
+            fill(*quote, names[symbol], i);
+            events.push_back(std::move(quote));
+        }
+    }
+
+    return recording;
+}
+
+// Replays the recorded batches through the decoding loop of the feed thread.
+void replay(const std::string &kind, const std::vector<std::string> &names, const Recording &recording) {
+    SymbolTable symbols{};
+    EventBatch batch{};
+
+    for (const auto &name : names) {
+        symbols.intern(name);
+    }
+
+    std::size_t next = 0;
+
+    report(measureBatches("decode/intern/" + kind, BATCH_SIZE, [&] {
+        const auto &events = recording[next++ % recording.size()];
+        auto *records = batch.allocate(events.size());
+
+        for (std::size_t i = 0; i < events.size(); i++) {
+            marshal(*events[i], symbols.intern(events[i]->eventSymbol), records[i]);
+        }
+
+        doNotOptimize(records[0].event.symbol_id);
+    }));
+
+    report(measureBatches("decode/run-cache/" + kind, BATCH_SIZE, [&] {
+        const auto &events = recording[next++ % recording.size()];
+        auto *records = batch.allocate(events.size());
+        SymbolTable::RunCache symbolIds{symbols};
+
+        for (std::size_t i = 0; i < events.size(); i++) {
+            marshal(*events[i], symbolIds.intern(events[i]->eventSymbol), records[i]);
+        }
+
+        doNotOptimize(records[0].event.symbol_id);
+    }));
+}
+
+std::vector<std::string> makeNames(const char *suffix) {
+    std::vector<std::string> names{};
+
+    for (std::size_t i = 0; i < SYMBOLS; i++) {
+        names.push_back("SYM" + std::to_string(i) + suffix);
+    }
+
+    return names;
+}
+
+} // namespace
+
+void runDecodeBench() {
+    for (const auto *suffix : {"", "{=1m,price=mark}"}) {
+        auto names = makeNames(suffix);
+        auto kind = std::string{*suffix == '\0' ? "tickers" : "candles"};
+
+        for (std::size_t runLength : {1, 8, 64}) {
+            replay(kind + "/run=" + std::to_string(runLength), names, record(names, runLength));
+        }
+    }
+}
+
+void runMaterializeBench() {
+    run("tickers", makeNames(""));
+    // Longer than the small string buffer.
+    run("candles", makeNames("{=1m,price=mark}"));
+}
+
+} // namespace dsp::bench
@@ -0,0 +1,242 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#include "Bench.hpp"
+
+#include <plugin-api.h>
+
+#include "Histogram.hpp"
+#include "Pipeline.hpp"
+#include "Router.hpp"
+#include "SnapshotTable.hpp"
+#include "Subscriber.hpp"
+#include "SymbolTable.hpp"
+#include "SyntheticGenerator.hpp"
+#include "SyntheticSource.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dsp::bench {
+
+namespace {
+
+// The shape of the events of the C++ API: the polymorphic objects delivered by a subscription as a vector of
+// shared_ptr to the base class.
+struct EventObject {
+    virtual ~EventObject() = default;
+
+    std::string eventSymbol{};
+    std::int64_t eventTime{};
+};
+
+struct QuoteObject final : EventObject {
+    double bidPrice{};
+    double bidSize{};
+    double askPrice{};
+    double askSize{};
+};
+
+struct TradeObject final : EventObject {
+    double price{};
+    double size{};
+    double dayVolume{};
+};
+
+using Events = std::vector<std::shared_ptr<EventObject>>;
+
+// The batches of one delivery: the feed delivers the quotes and the trades by the separate subscriptions.
+struct Delivery {
+    Events quotes{};
+    Events trades{};
+};
+
+void marshal(const QuoteObject &q, std::uint32_t symbolId, dsp_event_record_t &record) noexcept {
+    record.quote = dsp_quote_t{{sizeof(dsp_quote_t), DSP_ET_QUOTE, symbolId, 0},
+                               q.bidPrice,
+                               q.bidSize,
+                               q.askPrice,
+                               q.askSize};
+}
+
+void marshal(const TradeObject &tr, std::uint32_t symbolId, dsp_event_record_t &record) noexcept {
+    record.trade = dsp_trade_t{{sizeof(dsp_trade_t), DSP_ET_TRADE, symbolId, 0}, tr.price, tr.size, tr.dayVolume};
+}
+
+std::int64_t currentTimeMillis() noexcept {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+// The listener of the subscription to E: the loop of the feed thread of the plugin.
+template <typename E>
+std::size_t marshal(const Events &events, SymbolTable &symbols, dsp_event_record_t *records, Histogram &lags) {
+    SymbolTable::RunCache symbolIds{symbols};
+    auto now = currentTimeMillis();
+    std::size_t size = 0;
+
+    for (const auto &e : events) {
+        const auto &event = static_cast<const E &>(*e);
+
+        marshal(event, symbolIds.intern(event.eventSymbol), records[size++]);
+
+        if (event.eventTime > 0) {
+            lags.recordSingleWriter(static_cast<std::uint64_t>(std::max<std::int64_t>(now - event.eventTime, 0)) *
+                                    1'000'000);
+        }
+    }
+
+    return size;
+}
+
+// Generates the deliveries of the synthetic feed in advance, so only the plugin is measured.
+std::vector<Delivery> generate(SyntheticGenerator &generator, std::size_t batchSize) {
+    static constexpr std::size_t DELIVERIES = 64;
+
+    std::vector<Delivery> deliveries(DELIVERIES);
+    auto now = currentTimeMillis();
+
+    for (auto &delivery : deliveries) {
+        for (std::size_t i = 0; i < batchSize; i++) {
+            auto tick = generator.next();
+            const auto &symbol = generator.getSymbols()[tick.symbol];
+
+            if (tick.type == DSP_ET_QUOTE) {
+                auto quote = std::make_shared<QuoteObject>();
+
+                quote->eventSymbol = symbol;
+                quote->eventTime = now;
+                quote->bidPrice = tick.bidPrice;
+                quote->bidSize = tick.bidSize;
+                quote->askPrice = tick.askPrice;
+                quote->askSize = tick.askSize;
+                delivery.quotes.push_back(std::move(quote));
+            } else {
+                auto trade = std::make_shared<TradeObject>();
+
+                trade->eventSymbol = symbol;
+                trade->eventTime = now;
+                trade->price = tick.price;
+                trade->size = tick.size;
+                delivery.trades.push_back(std::move(trade));
+            }
+        }
+    }
+
+    return deliveries;
+}
+
+void consume(dsp_event_t **events, size_t size, void *userData) {
+    auto &checksum = *static_cast<std::uint64_t *>(userData);
+
+    for (std::size_t i = 0; i < size; i++) {
+        checksum += events[i]->symbol_id;
+    }
+}
+
+void run(SyntheticGenerator::Distribution distribution, const char *distributionName) {
+    const auto &options = getOptions();
+    SyntheticGenerator generator{{options.symbols, 0.2, distribution}};
+    auto deliveries = generate(generator, options.batchSize);
+
+    SymbolTable symbols{};
+    Router router{};
+    SnapshotTable snapshots{};
+    std::uint64_t checksum = 0;
+    auto *subscriber = router.addSubscriber(Subscriber::events(consume, &checksum));
+
+    router.update([&] {
+        for (const auto &symbol : generator.getSymbols()) {
+            router.addRoute(symbols.intern(symbol), subscriber, DSP_EVENT_TYPE_MASK_DEFAULT);
+        }
+    });
+
+    auto name = "pipeline/batch=" + std::to_string(options.batchSize) + "/symbols=" + std::to_string(options.symbols) +
+                "/threads=" + std::to_string(options.dispatchThreads) + "/" + distributionName;
+    std::size_t next = 0;
+
+    {
+        // Destroyed (and drained) before the router and the snapshots.
+        Pipeline pipeline{router, snapshots};
+
+        pipeline.setDispatchThreads(options.dispatchThreads);
+
+        report(measureBatches(name, options.batchSize, [&] {
+            const auto &delivery = deliveries[next++ % deliveries.size()];
+
+            pipeline.process(DSP_ET_QUOTE, delivery.quotes.size(), [&](dsp_event_record_t *records, Histogram &lags) {
+                return marshal<QuoteObject>(delivery.quotes, symbols, records, lags);
+            });
+            pipeline.process(DSP_ET_TRADE, delivery.trades.size(), [&](dsp_event_record_t *records, Histogram &lags) {
+                return marshal<TradeObject>(delivery.trades, symbols, records, lags);
+            });
+        }));
+    }
+
+    doNotOptimize(checksum);
+}
+
+// The synthetic source of the plugin (dsp_connect("synthetic:...")) at the maximal rate: the generation on its own
+// thread, the pipeline and the listener.
+void runSource() {
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr auto DURATION = std::chrono::milliseconds(300);
+
+    const auto &options = getOptions();
+    auto address = "synthetic:symbols=" + std::to_string(options.symbols) +
+                   ",batch=" + std::to_string(options.batchSize);
+    auto config = SyntheticSource::parse(address);
+    SyntheticGenerator generator{config.generator};
+
+    SymbolTable symbols{};
+    Router router{};
+    SnapshotTable snapshots{};
+    std::uint64_t checksum = 0;
+    auto *subscriber = router.addSubscriber(Subscriber::events(consume, &checksum));
+
+    router.update([&] {
+        for (const auto &symbol : generator.getSymbols()) {
+            router.addRoute(symbols.intern(symbol), subscriber, DSP_EVENT_TYPE_MASK_DEFAULT);
+        }
+    });
+
+    std::uint64_t events = 0;
+    auto start = Clock::now();
+
+    {
+        // Destroyed (and drained) after the source.
+        Pipeline pipeline{router, snapshots};
+
+        pipeline.setDispatchThreads(options.dispatchThreads);
+
+        SyntheticSource source{pipeline, symbols};
+
+        source.connect(address);
+        std::this_thread::sleep_for(DURATION);
+        events = source.getDeliveredCount();
+    }
+
+    auto ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    auto name = "pipeline/source/batch=" + std::to_string(options.batchSize) +
+                "/symbols=" + std::to_string(options.symbols) + "/threads=" + std::to_string(options.dispatchThreads);
+
+    report(Result{std::move(name), events / options.batchSize, events, ns / static_cast<double>(events),
+                  static_cast<double>(events) * 1e9 / ns});
+    doNotOptimize(checksum);
+}
+
+} // namespace
+
+void runPipelineBench() {
+    run(SyntheticGenerator::Distribution::UNIFORM, "uniform");
+    run(SyntheticGenerator::Distribution::ZIPF, "zipf");
+    runSource();
+}
+
+} // namespace dsp::bench
@@ -0,0 +1,161 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#include "Bench.hpp"
+
+#include "Probe.hpp"
+#include "StopWatch.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace dsp::bench {
+
+namespace {
+
+constexpr std::size_t SECTIONS = 256;
+
+// The StopWatch of the SDK: milliseconds, a mutex per call.
+class LockedStopWatch final {
+    mutable std::mutex mutex_{};
+    std::chrono::milliseconds elapsed_{};
+    std::chrono::steady_clock::time_point start_{};
+    bool running_{};
+
+  public:
+    void start() {
+        std::lock_guard lock{mutex_};
+
+        if (!running_) {
+            start_ = std::chrono::steady_clock::now();
+            running_ = true;
+        }
+    }
+
+    void stop() {
+        auto end = std::chrono::steady_clock::now();
+        std::lock_guard lock{mutex_};
+
+        if (running_) {
+            elapsed_ += std::chrono::duration_cast<std::chrono::milliseconds>(end - start_);
+            running_ = false;
+        }
+    }
+
+    std::chrono::milliseconds elapsed() const {
+        std::lock_guard lock{mutex_};
+
+        return elapsed_;
+    }
+};
+
+// The timed section: a short loop, as the marshaling of a few events.
+std::uint64_t section(std::uint64_t seed) noexcept {
+    for (std::size_t i = 0; i < 16; i++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    }
+
+    return seed;
+}
+
+} // namespace
+
+void runProbeBench() {
+    std::uint64_t seed = 1;
+
+    report(measure("probe/none", SECTIONS, [&] {
+        for (std::size_t i = 0; i < SECTIONS; i++) {
+            seed = section(seed);
+        }
+
+        doNotOptimize(seed);
+    }));
+
+    LockedStopWatch locked{};
+
+    report(measure("probe/sdk-stop-watch", SECTIONS, [&] {
+        for (std::size_t i = 0; i < SECTIONS; i++) {
+            locked.start();
+            seed = section(seed);
+            locked.stop();
+        }
+
+        doNotOptimize(seed);
+    }));
+
+    doNotOptimize(locked.elapsed().count());
+
+    StopWatch stopWatch{};
+
+    report(measure("probe/stop-watch", SECTIONS, [&] {
+        for (std::size_t i = 0; i < SECTIONS; i++) {
+            stopWatch.start();
+            seed = section(seed);
+            stopWatch.stop();
+        }
+
+        doNotOptimize(seed);
+    }));
+
+    doNotOptimize(stopWatch.elapsed().count());
+
+    ProbeSite site{"bench"};
+
+    report(measure("probe/scoped-disabled", SECTIONS, [&] {
+        for (std::size_t i = 0; i < SECTIONS; i++) {
+            BasicScopedProbe<false> probe{site};
+
+            seed = section(seed);
+        }
+
+        doNotOptimize(seed);
+    }));
+
+    report(measure("probe/scoped-enabled", SECTIONS, [&] {
+        for (std::size_t i = 0; i < SECTIONS; i++) {
+            BasicScopedProbe<true> probe{site};
+
+            seed = section(seed);
+        }
+
+        doNotOptimize(seed);
+    }));
+
+    Histogram histogram{};
+
+    site.collect(histogram);
+    std::printf("%-48s %12llu sections %8llu ns p50 %8llu ns p99 %8llu ns max\n", "probe/scoped-enabled/recorded",
+                static_cast<unsigned long long>(histogram.getCount()),
+                static_cast<unsigned long long>(histogram.getValueAtPercentile(0.5)),
+                static_cast<unsigned long long>(histogram.getValueAtPercentile(0.99)),
+                static_cast<unsigned long long>(histogram.getMax()));
+
+    // The lag of every event of a batch is recorded: the shared histogram with the atomic increments and the
+    // per-thread one with the plain stores.
+    Histogram shared{};
+
+    report(measure("probe/histogram-atomic", SECTIONS, [&] {
+        for (std::size_t i = 0; i < SECTIONS; i++) {
+            seed = section(seed);
+            shared.record(seed >> 40);
+        }
+
+        doNotOptimize(seed);
+    }));
+
+    ProbeSite lags{"bench-lags"};
+
+    report(measure("probe/histogram-single-writer", SECTIONS, [&] {
+        auto &local = lags.local();
+
+        for (std::size_t i = 0; i < SECTIONS; i++) {
+            seed = section(seed);
+            local.recordSingleWriter(seed >> 40);
+        }
+
+        doNotOptimize(seed);
+    }));
+}
+
+} // namespace dsp::bench
@@ -0,0 +1,102 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#include "Bench.hpp"
+
+#include <plugin-api.h>
+
+#include "EventQueue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dsp::bench {
+
+namespace {
+
+constexpr std::size_t BATCH_SIZE = 256;
+constexpr std::size_t POLL_SIZE = 1024;
+constexpr auto DURATION = std::chrono::milliseconds(300);
+
+} // namespace
+
+// The cost of the queue itself (offer and poll on the same thread) and the throughput of the transfer between a
+// synthetic producer thread and a consumer thread.
+void runQueueBench() {
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<dsp_event_record_t> batch(BATCH_SIZE);
+    std::vector<std::uint32_t> indices(BATCH_SIZE);
+    std::vector<dsp_event_record_t> buffer(POLL_SIZE);
+
+    for (std::size_t i = 0; i < BATCH_SIZE; i++) {
+        batch[i].quote = dsp_quote_t{{sizeof(dsp_quote_t), DSP_ET_QUOTE, static_cast<std::uint32_t>(i), 0},
+                                     100.0, 1.0, 100.01, 1.0};
+    }
+
+    std::iota(indices.begin(), indices.end(), 0);
+
+    {
+        EventQueue queue{POLL_SIZE};
+
+        report(measure("queue/offer+poll/same-thread", BATCH_SIZE, [&] {
+            queue.offer(batch.data(), indices);
+            doNotOptimize(queue.poll(buffer.data(), buffer.size()));
+        }));
+    }
+
+    for (std::size_t capacity : {4096, 65536}) {
+        EventQueue queue{capacity};
+        std::atomic<bool> stopped{};
+
+        // The producer does not outrun the consumer by more than the capacity: the bench measures the transfer, not the
+        // dropping.
+        std::thread producer([&] {
+            while (!stopped.load(std::memory_order_relaxed)) {
+                if (queue.size() + BATCH_SIZE > queue.capacity()) {
+                    std::this_thread::yield();
+
+                    continue;
+                }
+
+                queue.offer(batch.data(), indices);
+            }
+        });
+
+        std::size_t polled = 0;
+        double checksum = 0;
+        auto start = Clock::now();
+        auto now = start;
+
+        do {
+            auto size = queue.poll(buffer.data(), buffer.size());
+
+            if (size == 0) {
+                std::this_thread::yield();
+            }
+
+            for (std::size_t i = 0; i < size; i++) {
+                checksum += buffer[i].quote.bid_price;
+            }
+
+            polled += size;
+            now = Clock::now();
+        } while (now - start < DURATION);
+
+        stopped = true;
+        producer.join();
+        doNotOptimize(checksum);
+
+        auto ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count());
+
+        report(Result{"queue/spsc-transfer/capacity=" + std::to_string(capacity), polled, polled,
+                ns / static_cast<double>(polled), static_cast<double>(polled) * 1e9 / ns});
+    }
+}
+
+} // namespace dsp::bench
@@ -0,0 +1,97 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#include "Bench.hpp"
+
+#include "SegmentedArray.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dsp::bench {
+
+namespace {
+
+constexpr std::size_t ENTITIES = 10000;
+constexpr std::size_t LOOKUPS = 1024;
+
+struct Entity {
+    std::uint64_t value{};
+};
+
+// The registry of the SDK entities: the maps by id under one mutex.
+class LockedRegistry final {
+    std::mutex mutex_{};
+    std::unordered_map<std::size_t, Entity *> entities_{};
+
+  public:
+    void add(std::size_t id, Entity *entity) {
+        std::lock_guard lock{mutex_};
+
+        entities_[id] = entity;
+    }
+
+    Entity *find(std::size_t id) {
+        std::lock_guard lock{mutex_};
+
+        auto found = entities_.find(id);
+
+        return found == entities_.end() ? nullptr : found->second;
+    }
+};
+
+std::vector<std::size_t> makeIds() {
+    std::mt19937_64 random{42};
+    std::uniform_int_distribution<std::size_t> ids{0, ENTITIES - 1};
+    std::vector<std::size_t> result(LOOKUPS);
+
+    for (auto &id : result) {
+        id = ids(random);
+    }
+
+    return result;
+}
+
+} // namespace
+
+void runRegistryBench() {
+    auto ids = makeIds();
+    std::vector<Entity> entities(ENTITIES);
+    LockedRegistry locked{};
+    SegmentedArray<Entity> segmented{};
+
+    for (std::size_t id = 0; id < ENTITIES; id++) {
+        locked.add(id, &entities[id]);
+        segmented.findOrAllocate(id)->value = id;
+    }
+
+    for (std::size_t threads : {1, 2, 4, 8}) {
+        auto suffix = "/threads=" + std::to_string(threads);
+
+        report(measureConcurrently("registry/locked" + suffix, threads, LOOKUPS, [&] {
+            std::uint64_t sum = 0;
+
+            for (auto id : ids) {
+                sum += locked.find(id)->value;
+            }
+
+            doNotOptimize(sum);
+        }));
+
+        report(measureConcurrently("registry/segmented" + suffix, threads, LOOKUPS, [&] {
+            std::uint64_t sum = 0;
+
+            for (auto id : ids) {
+                sum += segmented.find(id)->value;
+            }
+
+            doNotOptimize(sum);
+        }));
+    }
+}
+
+} // namespace dsp::bench
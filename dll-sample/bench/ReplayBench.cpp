@@ -0,0 +1,138 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#include "Bench.hpp"
+
+#include <plugin-api.h>
+
+#include "StopWatch.hpp"
+#include "SymbolTable.hpp"
+#include "SyntheticGenerator.hpp"
+#include "TickRecorder.hpp"
+#include "TickReplay.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace dsp::bench {
+
+namespace {
+
+struct Checksum {
+    std::uint64_t symbols{};
+    double prices{};
+};
+
+// Reads the events in place, as a consumer would.
+void consume(dsp_event_t **events, size_t size, void *userData) {
+    auto &checksum = *static_cast<Checksum *>(userData);
+
+    for (std::size_t i = 0; i < size; i++) {
+        checksum.symbols += events[i]->symbol_id;
+
+        if (events[i]->type == DSP_ET_QUOTE) {
+            checksum.prices += reinterpret_cast<const dsp_quote_t *>(events[i])->bid_price;
+        } else {
+            checksum.prices += reinterpret_cast<const dsp_trade_t *>(events[i])->price;
+        }
+    }
+}
+
+// The marshaled batches of the synthetic feed, generated in advance.
+std::vector<std::vector<dsp_event_record_t>> generate(SymbolTable &symbols, std::size_t batchSize) {
+    static constexpr std::size_t BATCHES = 64;
+
+    const auto &options = getOptions();
+    SyntheticGenerator generator{{options.symbols, 0.2, SyntheticGenerator::Distribution::ZIPF}};
+    std::vector<std::uint32_t> symbolIds{};
+    std::vector<std::vector<dsp_event_record_t>> batches(BATCHES);
+
+    for (const auto &symbol : generator.getSymbols()) {
+        symbolIds.push_back(symbols.intern(symbol));
+    }
+
+    for (auto &batch : batches) {
+        batch.resize(batchSize);
+
+        for (auto &record : batch) {
+            auto tick = generator.next();
+            auto symbolId = symbolIds[tick.symbol];
+
+            if (tick.type == DSP_ET_QUOTE) {
+                record.quote = dsp_quote_t{{sizeof(dsp_quote_t), DSP_ET_QUOTE, symbolId, 0},
+                                           tick.bidPrice,
+                                           tick.bidSize,
+                                           tick.askPrice,
+                                           tick.askSize};
+            } else {
+                record.trade =
+                    dsp_trade_t{{sizeof(dsp_trade_t), DSP_ET_TRADE, symbolId, 0}, tick.price, tick.size, 0};
+            }
+        }
+    }
+
+    return batches;
+}
+
+} // namespace
+
+void runReplayBench() {
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t REPLAYS = 3;
+
+    const auto &options = getOptions();
+    auto fileName = (std::filesystem::temp_directory_path() / "dllsample-bench.ticks").string();
+    SymbolTable symbols{};
+    auto batches = generate(symbols, options.batchSize);
+    auto suffix = "/batch=" + std::to_string(options.batchSize) + "/symbols=" + std::to_string(options.symbols);
+    std::uint64_t recorded = 0;
+
+    {
+        TickRecorder recorder{symbols};
+        std::size_t next = 0;
+
+        if (!recorder.start(fileName)) {
+            std::fprintf(stderr, "replay: can't create %s\n", fileName.c_str());
+
+            return;
+        }
+
+        report(measureBatches("replay/record" + suffix, options.batchSize, [&] {
+            const auto &batch = batches[next++ % batches.size()];
+
+            recorder.record(StopWatch::now(), batch.data(), batch.size());
+        }));
+
+        recorded = recorder.getEventCount();
+    }
+
+    auto replay = TickReplay::open(fileName);
+
+    if (replay == nullptr || replay->getEventCount() != recorded) {
+        std::fprintf(stderr, "replay: %s is damaged\n", fileName.c_str());
+    } else {
+        // The first replay pages the file in.
+        for (std::size_t i = 0; i < REPLAYS; i++) {
+            Checksum checksum{};
+            auto start = Clock::now();
+            auto events = replay->replay(0, consume, &checksum);
+            auto ns = static_cast<double>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+
+            report(Result{"replay/replay" + suffix + "/run=" + std::to_string(i), events / options.batchSize, events,
+                          ns / static_cast<double>(events), static_cast<double>(events) * 1e9 / ns});
+            doNotOptimize(checksum.symbols);
+            doNotOptimize(checksum.prices);
+        }
+    }
+
+    replay.reset();
+    std::filesystem::remove(fileName);
+}
+
+} // namespace dsp::bench
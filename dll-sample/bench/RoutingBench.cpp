@@ -0,0 +1,154 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#include "Bench.hpp"
+
+#include <plugin-api.h>
+
+#include "Router.hpp"
+
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dsp::bench {
+
+namespace {
+
+constexpr std::size_t BATCH_SIZE = 1024;
+
+void countRecords(const dsp_event_record_t * /*records*/, std::size_t size, void *userData) {
+    *static_cast<std::size_t *>(userData) += size;
+}
+
+std::vector<dsp_event_record_t> makeBatch(std::size_t symbols) {
+    std::mt19937_64 random{42};
+    std::uniform_int_distribution<std::uint32_t> symbolIds{0, static_cast<std::uint32_t>(symbols - 1)};
+    std::vector<dsp_event_record_t> batch(BATCH_SIZE);
+
+    for (auto &record : batch) {
+        record.quote = dsp_quote_t{{sizeof(dsp_quote_t), DSP_ET_QUOTE, symbolIds(random), 0}, 100.0, 1.0, 100.01, 1.0};
+    }
+
+    return batch;
+}
+
+void runContentionBench() {
+    static constexpr std::size_t SYMBOLS = 1000;
+
+    auto batch = makeBatch(SYMBOLS);
+    std::vector<std::size_t> counters(SYMBOLS);
+    Router router{};
+
+    router.update([&] {
+        for (std::uint32_t symbolId = 0; symbolId < SYMBOLS; symbolId++) {
+            auto *subscriber = router.addSubscriber(Subscriber::records(countRecords, &counters[symbolId]));
+
+            router.addRoute(symbolId, subscriber, DSP_EVENT_TYPE_MASK_DEFAULT);
+        }
+    });
+
+    // The previous router held its recursive mutex (the one the registrations take) for the whole dispatch.
+    std::recursive_mutex mutex{};
+
+    for (std::size_t threads : {1, 2, 4, 8}) {
+        // More threads than cores measure the scheduler, not the contention.
+        if (threads > 1 && threads > std::thread::hardware_concurrency()) {
+            std::fprintf(stderr, "routing/contention/threads=%zu skipped: %u cores\n", threads,
+                         std::thread::hardware_concurrency());
+
+            continue;
+        }
+
+        auto suffix = "/threads=" + std::to_string(threads);
+
+        report(measureConcurrently("routing/contention/locked" + suffix, threads, BATCH_SIZE, [&] {
+            std::lock_guard lock{mutex};
+
+            router.dispatch(batch.data(), batch.size());
+        }));
+
+        report(measureConcurrently("routing/contention/snapshot" + suffix, threads, BATCH_SIZE, [&] {
+            router.dispatch(batch.data(), batch.size());
+        }));
+    }
+}
+
+// Subscribes the symbols one by one: every published change rebuilds the snapshot of all the routes, the deferred
+// changes are published once.
+void runSubscribeBench() {
+    // The published changes cost O(N^2), so the larger counts would take minutes.
+    for (std::size_t symbols : {100, 1000}) {
+        std::vector<std::size_t> counters(symbols);
+        auto subscribe = [&](Router &router, std::uint32_t symbolId) {
+            auto *subscriber = router.addSubscriber(Subscriber::records(countRecords, &counters[symbolId]));
+
+            router.addRoute(symbolId, subscriber, DSP_EVENT_TYPE_MASK_DEFAULT);
+        };
+
+        report(measure("routing/subscribe/published/symbols=" + std::to_string(symbols), symbols, [&] {
+            Router router{};
+
+            for (std::uint32_t symbolId = 0; symbolId < symbols; symbolId++) {
+                subscribe(router, symbolId);
+            }
+        }));
+
+        report(measure("routing/subscribe/deferred/symbols=" + std::to_string(symbols), symbols, [&] {
+            Router router{};
+
+            for (std::uint32_t symbolId = 0; symbolId < symbols; symbolId++) {
+                router.defer([&] {
+                    subscribe(router, symbolId);
+                });
+            }
+
+            router.flush();
+        }));
+    }
+}
+
+} // namespace
+
+void runRoutingBench() {
+    for (std::size_t symbols : {10, 100, 1000, 10000}) {
+        auto batch = makeBatch(symbols);
+        std::size_t delivered = 0;
+        // One counter per subscriber: a subscriber is identified by its callback and user data.
+        std::vector<std::size_t> counters(symbols);
+
+        Router router{};
+
+        router.update([&] {
+            for (std::uint32_t symbolId = 0; symbolId < symbols; symbolId++) {
+                auto *subscriber = router.addSubscriber(Subscriber::records(countRecords, &counters[symbolId]));
+
+                router.addRoute(symbolId, subscriber, DSP_EVENT_TYPE_MASK_DEFAULT);
+            }
+        });
+
+        report(measure("routing/hash-table/symbols=" + std::to_string(symbols), BATCH_SIZE, [&] {
+            router.dispatch(batch.data(), batch.size());
+            doNotOptimize(counters[0]);
+        }));
+
+        // The previous behavior: every listener sees the whole batch and has to filter out its own symbol.
+        report(measure("routing/broadcast/symbols=" + std::to_string(symbols), BATCH_SIZE, [&] {
+            for (std::uint32_t symbolId = 0; symbolId < symbols; symbolId++) {
+                for (const auto &record : batch) {
+                    delivered += record.event.symbol_id == symbolId;
+                }
+            }
+
+            doNotOptimize(delivered);
+        }));
+    }
+
+    runContentionBench();
+    runSubscribeBench();
+}
+
+} // namespace dsp::bench
@@ -0,0 +1,78 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#include "Bench.hpp"
+
+#include <plugin-api.h>
+
+#include "Router.hpp"
+#include "SymbolList.hpp"
+#include "SymbolTable.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dsp::bench {
+
+namespace {
+
+void countEvents(dsp_event_t ** /*events*/, std::size_t size, void *userData) {
+    *static_cast<std::size_t *>(userData) += size;
+}
+
+} // namespace
+
+void runSymbolListBench() {
+    for (std::size_t count : {1000, 10000, 100000}) {
+        std::vector<std::string> names{};
+        std::vector<const char *> pointers{};
+
+        // The second universe has 1% of the symbols replaced.
+        for (std::size_t i = 0; i < count + count / 100; i++) {
+            names.push_back("SYM" + std::to_string(i));
+        }
+
+        for (const auto &name : names) {
+            pointers.push_back(name.c_str());
+        }
+
+        SymbolTable symbols{};
+        Router router{};
+        std::size_t received = 0;
+        std::size_t changes = 0;
+        auto *subscriber = router.addSubscriber(Subscriber::events(countEvents, &received));
+        auto onChange = [&changes](std::uint32_t, Router::Change) {
+            changes++;
+        };
+        auto list = SymbolList::intern(symbols, pointers.data(), count);
+        auto shifted = SymbolList::intern(symbols, pointers.data() + count / 100, count);
+        auto suffix = "/symbols=" + std::to_string(count);
+
+        router.setRoutes(subscriber, list.getIds(), DSP_EVENT_TYPE_MASK_DEFAULT, onChange);
+
+        // The symbols are converted every time the universe is applied.
+        report(measure("symbol-list/strings" + suffix, count, [&] {
+            auto converted = SymbolList::intern(symbols, pointers.data(), count);
+
+            router.setRoutes(subscriber, converted.getIds(), DSP_EVENT_TYPE_MASK_DEFAULT, onChange);
+            doNotOptimize(changes);
+        }));
+
+        report(measure("symbol-list/prebuilt" + suffix, count, [&] {
+            router.setRoutes(subscriber, list.getIds(), DSP_EVENT_TYPE_MASK_DEFAULT, onChange);
+            doNotOptimize(changes);
+        }));
+
+        bool flip = false;
+
+        // Every application changes 2% of the routes (1% added, 1% removed).
+        report(measure("symbol-list/prebuilt-diff" + suffix, count, [&] {
+            flip = !flip;
+            router.setRoutes(subscriber, (flip ? shifted : list).getIds(), DSP_EVENT_TYPE_MASK_DEFAULT, onChange);
+            doNotOptimize(changes);
+        }));
+    }
+}
+
+} // namespace dsp::bench
@@ -0,0 +1,92 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#include "Bench.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+dsp::bench::Options &dsp::bench::getOptions() noexcept {
+    static Options options{};
+
+    return options;
+}
+
+// Parses the `<name>=<value>` option. Returns `false` if the argument is not the option.
+static bool parseOption(const char *argument, const char *name, std::size_t &value) {
+    auto length = std::strlen(name);
+
+    if (std::strncmp(argument, name, length) != 0 || argument[length] != '=') {
+        return false;
+    }
+
+    value = static_cast<std::size_t>(std::strtoull(argument + length + 1, nullptr, 10));
+
+    return true;
+}
+
+int main(int argc, char **argv) {
+    struct Scenario {
+        const char *name;
+        void (*run)();
+    };
+
+    static const Scenario scenarios[] = {
+        {"columns", dsp::bench::runColumnsBench},
+        {"routing", dsp::bench::runRoutingBench},
+        {"queue", dsp::bench::runQueueBench},
+        {"handler", dsp::bench::runHandlerBench},
+        {"materialize", dsp::bench::runMaterializeBench},
+        {"decode", dsp::bench::runDecodeBench},
+        {"registry", dsp::bench::runRegistryBench},
+        {"symbol-list", dsp::bench::runSymbolListBench},
+        {"probe", dsp::bench::runProbeBench},
+        {"pipeline", dsp::bench::runPipelineBench},
+        {"replay", dsp::bench::runReplayBench},
+    };
+
+    if (argc == 2 && (std::strcmp("-?", argv[1]) == 0 || std::strcmp("-h", argv[1]) == 0)) {
+        std::printf("Usage: %s [<option>...] [<scenario>...]\n"
+                    "Where:\n\n"
+                    "<option>   - --batch-size=<n>       - the events per batch (pipeline), 1024 - default\n"
+                    "             --symbols=<n>          - the symbols (pipeline), 1000 - default\n"
+                    "             --dispatch-threads=<n> - the dispatch threads (pipeline), 0 - default\n"
+                    "             --json                 - print the results as JSON lines\n"
+                    "<scenario> - the scenario to run, all scenarios are run by default:\n",
+                    argv[0]);
+
+        for (const auto &scenario : scenarios) {
+            std::printf("             %s\n", scenario.name);
+        }
+
+        return 0;
+    }
+
+    auto &options = dsp::bench::getOptions();
+    std::vector<const char *> selectedNames{};
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp("--json", argv[i]) == 0) {
+            options.json = true;
+        } else if (!parseOption(argv[i], "--batch-size", options.batchSize) &&
+                   !parseOption(argv[i], "--symbols", options.symbols) &&
+                   !parseOption(argv[i], "--dispatch-threads", options.dispatchThreads)) {
+            selectedNames.push_back(argv[i]);
+        }
+    }
+
+    for (const auto &scenario : scenarios) {
+        bool selected = selectedNames.empty();
+
+        for (const auto *name : selectedNames) {
+            selected = selected || std::strcmp(scenario.name, name) == 0;
+        }
+
+        if (selected) {
+            scenario.run();
+        }
+    }
+
+    return 0;
+}
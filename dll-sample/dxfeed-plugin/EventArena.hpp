@@ -0,0 +1,115 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace dsp {
+
+/// The alignment of the batch data (records, columns) so that every record occupies exactly one cache line and the
+/// columns can be processed with aligned vector loads.
+inline constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * A grow-only bump allocator that backs the events of one batch.
+ *
+ * The arena is reset at the beginning of every batch with the number of bytes the batch needs. The storage is
+ * reallocated only when a batch needs more than the current capacity, so in the steady state the delivery of a batch
+ * does not touch the heap. Everything allocated from the arena stays valid until the next reset.
+ *
+ * The arena is not thread-safe: every subscription owns its own arena and batches of one subscription are delivered
+ * sequentially.
+ */
+class EventArena final {
+    using Unit = std::max_align_t;
+
+    std::unique_ptr<Unit[]> storage_{};
+    std::size_t capacity_{};
+    std::size_t offset_{};
+
+    static constexpr std::size_t alignUp(std::size_t value, std::size_t alignment) noexcept {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+  public:
+    EventArena() noexcept = default;
+    EventArena(const EventArena &) = delete;
+    EventArena &operator=(const EventArena &) = delete;
+
+    /**
+     * Returns the number of bytes that must be reserved to allocate the array of `count` objects of type T (including
+     * the worst-case alignment padding).
+     *
+     * @tparam T The object type
+     * @tparam Alignment The alignment of the array
+     * @param count The number of objects
+     * @return The number of bytes
+     */
+    template <typename T, std::size_t Alignment = alignof(T)>
+    static constexpr std::size_t bytesFor(std::size_t count) noexcept {
+        return count * sizeof(T) + Alignment - 1;
+    }
+
+    /**
+     * Releases all the objects allocated since the previous reset and makes sure that at least `requiredBytes` can be
+     * allocated before the next reset.
+     *
+     * @param requiredBytes The number of bytes the next batch needs
+     */
+    void reset(std::size_t requiredBytes) {
+        offset_ = 0;
+
+        if (requiredBytes <= capacity_) {
+            return;
+        }
+
+        auto newCapacity = alignUp(std::max(requiredBytes, capacity_ * 2), sizeof(Unit));
+
+        storage_ = std::make_unique_for_overwrite<Unit[]>(newCapacity / sizeof(Unit));
+        capacity_ = newCapacity;
+    }
+
+    /**
+     * Allocates the storage for the array of `count` default-initialized objects of type T.
+     *
+     * @tparam T The object type (trivially destructible, the arena never calls destructors)
+     * @tparam Alignment The alignment of the array (e.g. the cache line size)
+     * @param count The number of objects
+     * @return The pointer to the first object or `nullptr` if the reserved capacity is exhausted
+     */
+    template <typename T, std::size_t Alignment = alignof(T)> T *allocateArray(std::size_t count) noexcept {
+        static_assert(std::is_trivially_destructible_v<T>);
+        static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0);
+
+        auto base = reinterpret_cast<std::uintptr_t>(storage_.get());
+        auto offset = alignUp(base + offset_, Alignment) - base;
+
+        if (offset + count * sizeof(T) > capacity_) {
+            return nullptr;
+        }
+
+        auto *ptr = reinterpret_cast<std::byte *>(storage_.get()) + offset;
+
+        offset_ = offset + count * sizeof(T);
+
+        std::uninitialized_default_construct_n(reinterpret_cast<T *>(ptr), count);
+
+        return std::launder(reinterpret_cast<T *>(ptr));
+    }
+
+    /**
+     * @return The number of bytes that can be used without reallocation.
+     */
+    std::size_t capacity() const noexcept {
+        return capacity_;
+    }
+};
+
+} // namespace dsp
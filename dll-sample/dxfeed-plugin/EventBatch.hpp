@@ -0,0 +1,94 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <plugin-api.h>
+
+#include "EventArena.hpp"
+#include "MpmcQueue.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dsp {
+
+/**
+ * The marshaled records of one batch on their way from the feed thread to the dispatch.
+ */
+struct EventBatch final {
+    EventArena arena{};
+    dsp_event_record_t *records{};
+    std::size_t size{};
+    // The times (StopWatch::now()) the batch was delivered to the plugin and marshaled.
+    std::int64_t receivedNs{};
+    std::int64_t marshaledNs{};
+
+    /**
+     * Forgets the previous records and allocates the storage for the new ones.
+     *
+     * @param capacity The maximal number of records
+     * @return The records.
+     */
+    dsp_event_record_t *allocate(std::size_t capacity) {
+        arena.reset(EventArena::bytesFor<dsp_event_record_t, CACHE_LINE_SIZE>(capacity));
+        records = arena.allocateArray<dsp_event_record_t, CACHE_LINE_SIZE>(capacity);
+        size = 0;
+
+        return records;
+    }
+};
+
+/**
+ * The lock-free pool of batches: the batches are recycled with their arenas, so in the steady state passing a batch to
+ * another thread does not allocate. The pool creates a new batch when it is empty and destroys the released batches
+ * that do not fit into it.
+ */
+class EventBatchPool final {
+    MpmcQueue<EventBatch *> free_;
+
+  public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 1024;
+
+    /**
+     * @param capacity The maximal number of the pooled batches
+     */
+    explicit EventBatchPool(std::size_t capacity = DEFAULT_CAPACITY) : free_{capacity} {
+    }
+
+    EventBatchPool(const EventBatchPool &) = delete;
+    EventBatchPool &operator=(const EventBatchPool &) = delete;
+
+    /**
+     * Destroys the pooled batches. All the batches must be released.
+     */
+    ~EventBatchPool() {
+        EventBatch *batch{};
+
+        while (free_.pop(batch)) {
+            delete batch;
+        }
+    }
+
+    /**
+     * @return The pooled or new batch.
+     */
+    EventBatch *acquire() {
+        EventBatch *batch{};
+
+        return free_.pop(batch) ? batch : new EventBatch{};
+    }
+
+    /**
+     * Returns the batch to the pool.
+     *
+     * @param batch The batch
+     */
+    void release(EventBatch *batch) noexcept {
+        if (!free_.push(batch)) {
+            delete batch;
+        }
+    }
+};
+
+} // namespace dsp
@@ -0,0 +1,89 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <plugin-api.h>
+
+#include "SpscRing.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dsp {
+
+/**
+ * The queue behind `dsp_open_queue`: the feed thread offers the records of every batch, the consumer polls them from
+ * its own thread without locks.
+ *
+ * The queue is bounded. The records that do not fit are dropped and counted, so a slow consumer never blocks the feed.
+ */
+class EventQueue final {
+    SpscRing<dsp_event_record_t> ring_;
+    std::atomic<std::uint64_t> overflowCount_{};
+
+  public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 65536;
+
+    /**
+     * @param capacity The minimal capacity in records (rounded up to a power of two) or 0 for the default capacity
+     * @throws std::length_error if the capacity is greater than SpscRing::MAX_CAPACITY
+     */
+    explicit EventQueue(std::size_t capacity) : ring_{capacity == 0 ? DEFAULT_CAPACITY : capacity} {
+    }
+
+    EventQueue(const EventQueue &) = delete;
+    EventQueue &operator=(const EventQueue &) = delete;
+
+    /**
+     * Enqueues the selected records of the batch (producer only).
+     *
+     * @param records The records of the batch
+     * @param indices The indices of the records to enqueue
+     */
+    void offer(const dsp_event_record_t *records, const std::vector<std::uint32_t> &indices) noexcept {
+        auto pushed = ring_.push(indices.size(), [records, &indices](std::size_t i) -> const dsp_event_record_t & {
+            return records[indices[i]];
+        });
+
+        if (pushed < indices.size()) {
+            overflowCount_.fetch_add(indices.size() - pushed, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Dequeues up to `maxCount` records (consumer only).
+     *
+     * @param records The buffer for the records
+     * @param maxCount The buffer size
+     * @return The number of dequeued records.
+     */
+    std::size_t poll(dsp_event_record_t *records, std::size_t maxCount) noexcept {
+        return ring_.pop(records, maxCount);
+    }
+
+    /**
+     * @return The total number of the records dropped because the queue was full.
+     */
+    std::uint64_t getOverflowCount() const noexcept {
+        return overflowCount_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @return The number of records in the queue (approximate while the queue is in use).
+     */
+    std::size_t size() const noexcept {
+        return ring_.size();
+    }
+
+    /**
+     * @return The capacity of the queue in records.
+     */
+    std::size_t capacity() const noexcept {
+        return ring_.capacity();
+    }
+};
+
+} // namespace dsp
@@ -0,0 +1,38 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace dsp {
+
+/**
+ * The source of the events of the plugin: the live feed or a synthetic one. The source delivers the batches of the
+ * events of the subscribed symbols to the pipeline (Pipeline::process()) on its own threads.
+ */
+class EventSource {
+  public:
+    virtual ~EventSource() = default;
+
+    /**
+     * Starts delivering the events.
+     *
+     * @param address The address of the source
+     */
+    virtual void connect(const std::string &address) = 0;
+
+    /**
+     * Applies the coalesced changes of the symbols of the event type.
+     *
+     * @param eventType The event type
+     * @param added The symbols to subscribe to
+     * @param removed The symbols to unsubscribe from
+     */
+    virtual void applySymbols(std::size_t eventType, const std::vector<std::string> &added,
+                              const std::vector<std::string> &removed) = 0;
+};
+
+} // namespace dsp
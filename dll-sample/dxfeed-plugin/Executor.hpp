@@ -0,0 +1,134 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include "MpmcQueue.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace dsp {
+
+/**
+ * Runs tasks either inline (on the caller's thread) or on a fixed set of persistent worker threads.
+ *
+ * Every worker is fed by its own bounded lock-free queue. A task is executed by the worker selected by the task's key,
+ * so the tasks with the same key are executed sequentially in the order of submission. The idle workers sleep on an
+ * atomic wait. A producer that finds the queue full yields until there is space, i.e. the queue exerts back pressure
+ * and tasks are never dropped (a task must not submit tasks to its own worker).
+ *
+ * @tparam Task The task type: a nothrow-movable callable `void()`
+ */
+template <typename Task> class Executor final {
+    struct Worker {
+        MpmcQueue<Task> queue;
+        // Incremented on every submission and on stop, the idle worker waits for it to change.
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t> epoch{};
+        std::thread thread{};
+
+        explicit Worker(std::size_t capacity) : queue{capacity} {
+        }
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_{};
+    std::atomic<bool> stopped_{};
+
+    void run(Worker &worker) {
+        Task task{};
+
+        for (;;) {
+            if (worker.queue.pop(task)) {
+                task();
+
+                continue;
+            }
+
+            auto epoch = worker.epoch.load(std::memory_order_acquire);
+
+            // A task submitted before the epoch was read is visible now.
+            if (worker.queue.pop(task)) {
+                task();
+
+                continue;
+            }
+
+            if (stopped_.load(std::memory_order_acquire)) {
+                return;
+            }
+
+            worker.epoch.wait(epoch, std::memory_order_acquire);
+        }
+    }
+
+  public:
+    static constexpr std::size_t DEFAULT_QUEUE_CAPACITY = 1024;
+
+    /**
+     * @param threads The number of worker threads or 0 to run the tasks inline
+     * @param queueCapacity The capacity of the queue of every worker
+     */
+    explicit Executor(std::size_t threads, std::size_t queueCapacity = DEFAULT_QUEUE_CAPACITY) {
+        workers_.reserve(threads);
+
+        for (std::size_t i = 0; i < threads; i++) {
+            auto &worker = *workers_.emplace_back(std::make_unique<Worker>(queueCapacity));
+
+            worker.thread = std::thread([this, &worker] {
+                run(worker);
+            });
+        }
+    }
+
+    Executor(const Executor &) = delete;
+    Executor &operator=(const Executor &) = delete;
+
+    /**
+     * Executes the remaining tasks and stops the workers.
+     */
+    ~Executor() {
+        stopped_.store(true, std::memory_order_release);
+
+        for (auto &worker : workers_) {
+            worker->epoch.fetch_add(1, std::memory_order_release);
+            worker->epoch.notify_one();
+            worker->thread.join();
+        }
+    }
+
+    /**
+     * Executes the task inline or submits it to the worker selected by the key.
+     *
+     * @param key The key: the tasks with the same key are executed sequentially in the order of submission
+     * @param task The task
+     */
+    void execute(std::size_t key, Task task) {
+        if (workers_.empty()) {
+            task();
+
+            return;
+        }
+
+        auto &worker = *workers_[key % workers_.size()];
+
+        while (!worker.queue.push(task)) {
+            std::this_thread::yield();
+        }
+
+        worker.epoch.fetch_add(1, std::memory_order_release);
+        worker.epoch.notify_one();
+    }
+
+    /**
+     * @return The number of worker threads (0 if the tasks are executed inline).
+     */
+    std::size_t getThreads() const noexcept {
+        return workers_.size();
+    }
+};
+
+} // namespace dsp
@@ -0,0 +1,188 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace dsp {
+
+/**
+ * The lock-free histogram of non-negative values (e.g. the latencies in nanoseconds) with log-linear buckets, as in
+ * HdrHistogram: every power of two range is split into Histogram::SUB_BUCKETS equal buckets, so the value of any
+ * percentile is known within ~3% whatever its magnitude, and the histogram has a fixed size (no allocations).
+ *
+ * Recording (Histogram::record()) is a few relaxed atomic increments, so any number of threads may record
+ * concurrently and the readers may read at the same time (they see the values recorded so far, not necessarily
+ * consistent with each other). A histogram recorded by one thread only (e.g. a per-thread one) is recorded with plain
+ * loads and stores (Histogram::recordSingleWriter()), which is cheap enough for every event of the hot path.
+ */
+class Histogram final {
+  public:
+    /// The number of the buckets per power of two range.
+    static constexpr std::size_t SUB_BUCKETS = 32;
+    /// The values are clamped to this value (~78 hours in nanoseconds).
+    static constexpr std::uint64_t MAX_VALUE = (std::uint64_t{1} << 48) - 1;
+
+  private:
+    static constexpr std::size_t SUB_BUCKET_BITS = std::countr_zero(SUB_BUCKETS);
+    static constexpr std::size_t BUCKETS =
+        SUB_BUCKETS + (std::bit_width(MAX_VALUE) - 1 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    std::array<std::atomic<std::uint64_t>, BUCKETS> counts_{};
+    std::atomic<std::uint64_t> count_{};
+    std::atomic<std::uint64_t> max_{};
+
+    static std::size_t indexOf(std::uint64_t value) noexcept {
+        if (value < SUB_BUCKETS) {
+            return static_cast<std::size_t>(value);
+        }
+
+        // The exponent of the bucket: the sub-bucket is taken from the SUB_BUCKET_BITS bits after the highest one.
+        auto exponent = static_cast<std::size_t>(std::bit_width(value) - 1 - SUB_BUCKET_BITS);
+
+        return SUB_BUCKETS + exponent * SUB_BUCKETS + static_cast<std::size_t>((value >> exponent) & (SUB_BUCKETS - 1));
+    }
+
+    // Returns the highest value of the bucket.
+    static std::uint64_t highestValueOf(std::size_t index) noexcept {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+
+        auto exponent = (index - SUB_BUCKETS) / SUB_BUCKETS;
+        auto subBucket = (index - SUB_BUCKETS) % SUB_BUCKETS;
+
+        return ((SUB_BUCKETS + subBucket + 1) << exponent) - 1;
+    }
+
+  public:
+    Histogram() = default;
+    Histogram(const Histogram &) = delete;
+    Histogram &operator=(const Histogram &) = delete;
+
+    /**
+     * Records the value.
+     *
+     * @param value The value
+     */
+    void record(std::uint64_t value) noexcept {
+        value = std::min(value, MAX_VALUE);
+        counts_[indexOf(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+
+        // The maximum rarely changes, so it is usually a load.
+        auto max = max_.load(std::memory_order_relaxed);
+
+        while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * Records the value. Only one thread may record into the histogram (by any of the functions), but the readers may
+     * read concurrently.
+     *
+     * @param value The value
+     */
+    void recordSingleWriter(std::uint64_t value) noexcept {
+        value = std::min(value, MAX_VALUE);
+
+        auto &bucket = counts_[indexOf(value)];
+
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        count_.store(count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        if (value > max_.load(std::memory_order_relaxed)) {
+            max_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Adds the recorded values to the other histogram (e.g. to merge the per-thread histograms).
+     *
+     * @param other The histogram to add to
+     */
+    void addTo(Histogram &other) const noexcept {
+        for (std::size_t i = 0; i < BUCKETS; i++) {
+            if (auto count = counts_[i].load(std::memory_order_relaxed); count != 0) {
+                other.counts_[i].fetch_add(count, std::memory_order_relaxed);
+            }
+        }
+
+        other.count_.fetch_add(count_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        auto max = max_.load(std::memory_order_relaxed);
+        auto otherMax = other.max_.load(std::memory_order_relaxed);
+
+        while (max > otherMax && !other.max_.compare_exchange_weak(otherMax, max, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * Forgets the recorded values. The values recorded concurrently may be partially forgotten.
+     */
+    void reset() noexcept {
+        for (auto &count : counts_) {
+            count.store(0, std::memory_order_relaxed);
+        }
+
+        count_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @return The number of the recorded values.
+     */
+    std::uint64_t getCount() const noexcept {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @return The maximal recorded value (exact) or 0 if there are no values.
+     */
+    std::uint64_t getMax() const noexcept {
+        return max_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Returns the value of the percentile: the highest value of the bucket that holds the percentile (so not less than
+     * the exact value and greater by ~3% at most), but not greater than the maximum.
+     *
+     * @param percentile The percentile in [0, 1] (e.g. 0.99)
+     * @return The value or 0 if there are no values.
+     */
+    std::uint64_t getValueAtPercentile(double percentile) const noexcept {
+        std::uint64_t total = 0;
+
+        for (const auto &count : counts_) {
+            total += count.load(std::memory_order_relaxed);
+        }
+
+        if (total == 0) {
+            return 0;
+        }
+
+        // The rank of the value: 1-based, so the 0th percentile is the smallest value.
+        auto rank = std::clamp(static_cast<std::uint64_t>(std::ceil(percentile * static_cast<double>(total))),
+                               std::uint64_t{1}, total);
+        std::uint64_t seen = 0;
+
+        for (std::size_t i = 0; i < BUCKETS; i++) {
+            seen += counts_[i].load(std::memory_order_relaxed);
+
+            if (seen >= rank) {
+                return std::min(highestValueOf(i), getMax());
+            }
+        }
+
+        return getMax();
+    }
+};
+
+} // namespace dsp
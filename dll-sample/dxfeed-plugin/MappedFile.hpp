@@ -0,0 +1,142 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#ifdef _WIN32
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+
+#    include <Windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace dsp {
+
+/**
+ * The copy-on-write memory mapping of a whole file. The contents are paged in on access, the mapping is page-aligned.
+ * The mapping may be written to: the written pages are copied, so the changes are private to the mapping and never
+ * reach the file.
+ */
+class MappedFile final {
+    std::byte *data_{};
+    std::size_t size_{};
+
+    MappedFile(std::byte *data, std::size_t size) noexcept : data_{data}, size_{size} {
+    }
+
+  public:
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+     * Unmaps the file.
+     */
+    ~MappedFile() {
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+#else
+        munmap(data_, size_);
+#endif
+    }
+
+    /**
+     * Maps the file.
+     *
+     * @param fileName The name of the file
+     * @return The mapping or `nullptr` if the file can't be mapped or is empty.
+     */
+    static std::unique_ptr<MappedFile> open(const std::string &fileName) {
+#ifdef _WIN32
+        auto file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+        if (file == INVALID_HANDLE_VALUE) {
+            return nullptr;
+        }
+
+        LARGE_INTEGER size{};
+
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0 ||
+            static_cast<unsigned long long>(size.QuadPart) > static_cast<std::size_t>(-1)) {
+            CloseHandle(file);
+
+            return nullptr;
+        }
+
+        // The view keeps the mapping and the file open.
+        auto mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        auto *data = mapping == nullptr ? nullptr : MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+
+        if (mapping != nullptr) {
+            CloseHandle(mapping);
+        }
+
+        CloseHandle(file);
+
+        if (data == nullptr) {
+            return nullptr;
+        }
+
+        return std::unique_ptr<MappedFile>(
+            new MappedFile(static_cast<std::byte *>(data), static_cast<std::size_t>(size.QuadPart)));
+#else
+        auto fd = ::open(fileName.c_str(), O_RDONLY);
+
+        if (fd < 0) {
+            return nullptr;
+        }
+
+        struct stat status {};
+
+        if (fstat(fd, &status) != 0 || status.st_size == 0) {
+            ::close(fd);
+
+            return nullptr;
+        }
+
+        auto size = static_cast<std::size_t>(status.st_size);
+        // The mapping keeps the file open.
+        auto *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+        ::close(fd);
+
+        if (data == MAP_FAILED) {
+            return nullptr;
+        }
+
+        // The file is read sequentially by the replay.
+        madvise(data, size, MADV_SEQUENTIAL);
+
+        return std::unique_ptr<MappedFile>(new MappedFile(static_cast<std::byte *>(data), size));
+#endif
+    }
+
+    /**
+     * @return The contents of the file.
+     */
+    std::byte *getData() const noexcept {
+        return data_;
+    }
+
+    /**
+     * @return The size of the file.
+     */
+    std::size_t getSize() const noexcept {
+        return size_;
+    }
+};
+
+} // namespace dsp
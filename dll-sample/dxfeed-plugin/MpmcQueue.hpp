@@ -0,0 +1,125 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include "EventArena.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace dsp {
+
+/**
+ * A bounded lock-free multi-producer/multi-consumer queue (D. Vyukov's algorithm).
+ *
+ * Every cell carries a sequence number that tells whether the cell is ready to be written (sequence == position) or
+ * read (sequence == position + 1) at the current lap, so producers and consumers only contend on their own position
+ * counters, which live on separate cache lines.
+ *
+ * @tparam T The item type (default constructible and movable)
+ */
+template <typename T> class MpmcQueue final {
+    static_assert(std::is_nothrow_move_assignable_v<T> && std::is_default_constructible_v<T>);
+
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> enqueuePosition_{};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> dequeuePosition_{};
+
+    static constexpr std::size_t roundUpToPowerOfTwo(std::size_t value) noexcept {
+        std::size_t result = 2;
+
+        while (result < value) {
+            result *= 2;
+        }
+
+        return result;
+    }
+
+  public:
+    /**
+     * @param capacity The minimal capacity (rounded up to a power of two)
+     */
+    explicit MpmcQueue(std::size_t capacity)
+        : mask_{roundUpToPowerOfTwo(capacity) - 1}, cells_{std::make_unique<Cell[]>(mask_ + 1)} {
+        for (std::size_t i = 0; i <= mask_; i++) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue &) = delete;
+    MpmcQueue &operator=(const MpmcQueue &) = delete;
+
+    /**
+     * @param value The item
+     * @return `false` if the queue is full (the item is not moved from then).
+     */
+    bool push(T &value) noexcept {
+        auto position = enqueuePosition_.load(std::memory_order_relaxed);
+
+        for (;;) {
+            auto &cell = cells_[position & mask_];
+            auto sequence = cell.sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+            if (difference == 0) {
+                if (enqueuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = enqueuePosition_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @param value The destination
+     * @return `false` if the queue is empty.
+     */
+    bool pop(T &value) noexcept {
+        auto position = dequeuePosition_.load(std::memory_order_relaxed);
+
+        for (;;) {
+            auto &cell = cells_[position & mask_];
+            auto sequence = cell.sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+
+            if (difference == 0) {
+                if (dequeuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    value = std::move(cell.value);
+                    cell.sequence.store(position + mask_ + 1, std::memory_order_release);
+
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = dequeuePosition_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @return The capacity of the queue.
+     */
+    std::size_t capacity() const noexcept {
+        return mask_ + 1;
+    }
+};
+
+} // namespace dsp
@@ -0,0 +1,162 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <plugin-api.h>
+
+#include "EventBatch.hpp"
+#include "Executor.hpp"
+#include "Histogram.hpp"
+#include "PipelineStats.hpp"
+#include "Probe.hpp"
+#include "Router.hpp"
+#include "SnapshotTable.hpp"
+#include "StopWatch.hpp"
+#include "TickRecorder.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+
+namespace dsp {
+
+/**
+ * The path of a batch of events from the feed listener to the consumers, independent of the source of the events:
+ * the batch is marshaled into the records on the calling (feed) thread, handed over to the executor and dispatched:
+ * the snapshots are updated and the records are routed to the subscribers. Every stage is timed (PipelineStats). The
+ * dispatched batches are also passed to the recorder, if any (TickRecorder).
+ */
+class Pipeline final {
+    // Dispatches the marshaled batch to the consumers.
+    struct DispatchTask {
+        Pipeline *pipeline{};
+        EventBatch *batch{};
+
+        void operator()() const {
+            pipeline->dispatch(batch);
+        }
+    };
+
+    Router &router_;
+    SnapshotTable &snapshots_;
+    TickRecorder *recorder_;
+    PipelineStats stats_{};
+    EventBatchPool batches_{};
+    // Runs the dispatch of the batches of every event type in order: inline on the feed thread by default or on the
+    // persistent worker threads (see Pipeline::setDispatchThreads()). Destroyed first, so the queued batches are
+    // dispatched while everything else is alive.
+    std::unique_ptr<Executor<DispatchTask>> executor_ = std::make_unique<Executor<DispatchTask>>(0);
+
+    // The timing probes of the hot path, recorded only if the plugin is built with DSP_PROBES=1.
+    static ProbeSite &marshalProbe() noexcept {
+        static ProbeSite site{"marshal"};
+
+        return site;
+    }
+
+    static ProbeSite &dispatchProbe() noexcept {
+        static ProbeSite site{"dispatch"};
+
+        return site;
+    }
+
+    // Prints the percentiles of the durations recorded by the probe.
+    static void reportProbe(std::ostream &stream, ProbeSite &site) {
+        Histogram histogram{};
+
+        site.collect(histogram);
+        stream << "dsp probe " << site.getName() << ": count = " << histogram.getCount()
+               << ", p50 = " << histogram.getValueAtPercentile(0.5) << " ns, p99 = "
+               << histogram.getValueAtPercentile(0.99) << " ns, max = " << histogram.getMax() << " ns\n";
+    }
+
+    void dispatch(EventBatch *batch) {
+        ScopedProbe probe{dispatchProbe()};
+
+        // The snapshots are updated first, so the callbacks see the values at least as fresh as the delivered ones.
+        snapshots_.update(batch->records, batch->size);
+        router_.dispatch(batch->records, batch->size);
+        stats_.recordDispatched(*batch, StopWatch::now());
+
+        // After the listeners, so the recording doesn't delay them.
+        if (recorder_ != nullptr) {
+            recorder_->record(batch->receivedNs, batch->records, batch->size);
+        }
+
+        batches_.release(batch);
+    }
+
+  public:
+    /**
+     * @param router The router of the records to the subscribers
+     * @param snapshots The snapshots updated by the records
+     * @param recorder The recorder of the dispatched batches or `nullptr`
+     */
+    Pipeline(Router &router, SnapshotTable &snapshots, TickRecorder *recorder = nullptr)
+        : router_{router}, snapshots_{snapshots}, recorder_{recorder} {
+    }
+
+    Pipeline(const Pipeline &) = delete;
+    Pipeline &operator=(const Pipeline &) = delete;
+
+    /// The largest useful number of the dispatch threads: the batches of every event type go to one thread.
+    static constexpr std::size_t MAX_DISPATCH_THREADS = DSP_ET_COUNT;
+
+    /**
+     * Sets the number of the dispatch threads (0 means the dispatch on the calling thread). Must not be called while
+     * the batches are processed.
+     *
+     * @param threads The number of threads
+     */
+    void setDispatchThreads(std::size_t threads) {
+        executor_ = std::make_unique<Executor<DispatchTask>>(threads);
+    }
+
+    /**
+     * Marshals the batch of events on the calling thread and dispatches it. The batches of one event type must be
+     * processed by one thread at a time.
+     *
+     * @param eventType The event type (the batches of every event type are dispatched in order)
+     * @param capacity The maximal number of records (the number of events)
+     * @param marshal The function that writes the records and records the lag of every event into the histogram (in
+     * nanoseconds by Histogram::recordSingleWriter()): `std::size_t(dsp_event_record_t *records, Histogram &lags)`,
+     * returns the number of records written
+     */
+    template <typename Marshal> void process(dsp_event_type_t eventType, std::size_t capacity, Marshal &&marshal) {
+        auto receivedNs = StopWatch::now();
+        auto *batch = batches_.acquire();
+
+        {
+            ScopedProbe probe{marshalProbe()};
+
+            batch->size = marshal(batch->allocate(capacity), stats_.getLocalLags());
+        }
+
+        batch->receivedNs = receivedNs;
+        batch->marshaledNs = StopWatch::now();
+        stats_.recordMarshaled(*batch);
+        executor_->execute(eventType, DispatchTask{this, batch});
+    }
+
+    /**
+     * @return The latency statistics.
+     */
+    PipelineStats &getStats() noexcept {
+        return stats_;
+    }
+
+    /**
+     * Prints the timing probes (if the probes are enabled, see DSP_PROBES).
+     *
+     * @param stream The stream
+     */
+    static void reportProbes(std::ostream &stream) {
+        if constexpr (PROBES_ENABLED) {
+            reportProbe(stream, marshalProbe());
+            reportProbe(stream, dispatchProbe());
+        }
+    }
+};
+
+} // namespace dsp
@@ -0,0 +1,115 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <plugin-api.h>
+
+#include "EventBatch.hpp"
+#include "Histogram.hpp"
+#include "Probe.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace dsp {
+
+/**
+ * The latency statistics of the stages of the pipeline: the marshaling of a batch, its dispatch (from the marshaled
+ * records to the return of the listeners), the whole batch, and the lag of the events behind their event times.
+ *
+ * Every stage is a ProbeSite: the feed and dispatch threads record into their own histograms with plain stores, so the
+ * statistics are always on. The readers merge the histograms (PipelineStats::read()).
+ */
+class PipelineStats final {
+    ProbeSite marshal_{"marshal"};
+    ProbeSite dispatch_{"dispatch"};
+    ProbeSite total_{"total"};
+    ProbeSite lag_{"lag"};
+
+    static dsp_latency_t latencyOf(ProbeSite &site) {
+        Histogram histogram{};
+
+        site.collect(histogram);
+
+        return {histogram.getCount(), histogram.getValueAtPercentile(0.5), histogram.getValueAtPercentile(0.99),
+                histogram.getValueAtPercentile(0.999), histogram.getMax()};
+    }
+
+  public:
+    PipelineStats() = default;
+    PipelineStats(const PipelineStats &) = delete;
+    PipelineStats &operator=(const PipelineStats &) = delete;
+
+    /**
+     * Returns the lag histogram of the calling thread: the feed thread records the lag of every event of a batch into
+     * it with Histogram::recordSingleWriter().
+     *
+     * @return The histogram of the lags in nanoseconds.
+     */
+    Histogram &getLocalLags() {
+        return lag_.local();
+    }
+
+    /**
+     * Records the marshaling of the batch (by the feed thread).
+     *
+     * @param batch The marshaled batch with the times set
+     */
+    void recordMarshaled(const EventBatch &batch) {
+        marshal_.record(batch.marshaledNs - batch.receivedNs);
+    }
+
+    /**
+     * Records the dispatch of the batch (by the dispatching thread).
+     *
+     * @param batch The dispatched batch
+     * @param dispatchedNs The time (StopWatch::now()) the listeners returned
+     */
+    void recordDispatched(const EventBatch &batch, std::int64_t dispatchedNs) {
+        dispatch_.record(dispatchedNs - batch.marshaledNs);
+        total_.record(dispatchedNs - batch.receivedNs);
+    }
+
+    /**
+     * Fills the fields of the statistics that fit into its `struct_size`.
+     *
+     * @param stats The statistics
+     * @return `false` if `struct_size` is less than the header.
+     */
+    bool read(dsp_stats_t &stats) {
+        static constexpr std::size_t HEADER_SIZE = offsetof(dsp_stats_t, marshal);
+
+        if (stats.struct_size < HEADER_SIZE) {
+            return false;
+        }
+
+        dsp_stats_t full{};
+
+        full.marshal = latencyOf(marshal_);
+        full.dispatch = latencyOf(dispatch_);
+        full.total = latencyOf(total_);
+        full.lag = latencyOf(lag_);
+
+        auto size = std::min<std::size_t>(stats.struct_size, sizeof(dsp_stats_t));
+
+        std::memcpy(reinterpret_cast<char *>(&stats) + HEADER_SIZE, reinterpret_cast<const char *>(&full) + HEADER_SIZE,
+                    size - HEADER_SIZE);
+
+        return true;
+    }
+
+    /**
+     * Forgets the recorded statistics. The values recorded concurrently may be partially forgotten.
+     */
+    void reset() {
+        marshal_.reset();
+        dispatch_.reset();
+        total_.reset();
+        lag_.reset();
+    }
+};
+
+} // namespace dsp
@@ -0,0 +1,236 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include "Histogram.hpp"
+#include "StopWatch.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// The timing probes are recorded only if the plugin is built with DSP_PROBES=1 (the DLLSAMPLE_PROBES CMake option),
+// otherwise the probes compile to nothing and may stay in the hot path.
+#ifndef DSP_PROBES
+#    define DSP_PROBES 0
+#endif
+
+namespace dsp {
+
+/// `true` if the timing probes are recorded.
+inline constexpr bool PROBES_ENABLED = DSP_PROBES != 0;
+
+/**
+ * The timed section of the code: the durations of the section are recorded into the per-thread histograms, so the
+ * threads running the section don't share cache lines and the recording does not contend. The histograms are merged
+ * when read (ProbeSite::collect()).
+ *
+ * Every live site takes one of ProbeSite::MAX_SITES thread-local slots, a destroyed site frees it for the next one.
+ * The sites created while all the slots are taken don't record (their statistics stay empty).
+ */
+class ProbeSite final {
+  public:
+    /// The maximal number of the live sites.
+    static constexpr std::size_t MAX_SITES = 64;
+
+  private:
+    // The histogram of a thread and the site it belongs to: a slot freed by a destroyed site is reused by another one.
+    struct LocalSlot {
+        std::uint64_t siteId{};
+        Histogram *histogram{};
+    };
+
+    // The slots of the live sites.
+    struct Slots {
+        std::mutex mutex{};
+        std::array<bool, MAX_SITES> taken{};
+    };
+
+    const char *name_;
+    // Unique for every site (unlike the index), 0 is never used.
+    std::uint64_t id_;
+    std::size_t index_;
+    std::mutex mutex_{};
+    // The histograms of the threads that have recorded, outlive the threads.
+    std::vector<std::unique_ptr<Histogram>> histograms_{};
+
+    static std::uint64_t nextId() noexcept {
+        static std::atomic<std::uint64_t> id{1};
+
+        return id++;
+    }
+
+    static Slots &getSlots() noexcept {
+        static Slots slots{};
+
+        return slots;
+    }
+
+    // Returns MAX_SITES if all the slots are taken.
+    static std::size_t takeSlot() noexcept {
+        auto &slots = getSlots();
+        std::lock_guard lock{slots.mutex};
+
+        for (std::size_t index = 0; index < MAX_SITES; index++) {
+            if (!slots.taken[index]) {
+                slots.taken[index] = true;
+
+                return index;
+            }
+        }
+
+        return MAX_SITES;
+    }
+
+    static void freeSlot(std::size_t index) noexcept {
+        auto &slots = getSlots();
+        std::lock_guard lock{slots.mutex};
+
+        slots.taken[index] = false;
+    }
+
+    // Site index -> the histogram of the calling thread.
+    static std::array<LocalSlot, MAX_SITES> &localSlots() noexcept {
+        thread_local std::array<LocalSlot, MAX_SITES> slots{};
+
+        return slots;
+    }
+
+    Histogram &createLocalHistogram() {
+        std::lock_guard lock{mutex_};
+
+        return *histograms_.emplace_back(std::make_unique<Histogram>());
+    }
+
+  public:
+    /**
+     * @param name The name of the site (a string literal)
+     */
+    explicit ProbeSite(const char *name) noexcept : name_{name}, id_{nextId()}, index_{takeSlot()} {
+    }
+
+    ProbeSite(const ProbeSite &) = delete;
+    ProbeSite &operator=(const ProbeSite &) = delete;
+
+    ~ProbeSite() {
+        if (index_ < MAX_SITES) {
+            freeSlot(index_);
+        }
+    }
+
+    /**
+     * @return The name of the site.
+     */
+    const char *getName() const noexcept {
+        return name_;
+    }
+
+    /**
+     * Returns the histogram of the calling thread: a thread-local load, the first call on a thread allocates the
+     * histogram. Only the calling thread may record into it (e.g. by Histogram::recordSingleWriter()).
+     *
+     * A site without a slot returns the scratch histogram of the calling thread, which is never collected.
+     *
+     * @return The histogram of the calling thread.
+     */
+    Histogram &local() {
+        if (index_ >= MAX_SITES) {
+            thread_local std::unique_ptr<Histogram> dropped{};
+
+            if (dropped == nullptr) {
+                dropped = std::make_unique<Histogram>();
+            }
+
+            return *dropped;
+        }
+
+        auto &slot = localSlots()[index_];
+
+        if (slot.siteId != id_) {
+            slot = LocalSlot{id_, &createLocalHistogram()};
+        }
+
+        return *slot.histogram;
+    }
+
+    /**
+     * Records the duration into the histogram of the calling thread without atomic read-modify-write operations.
+     *
+     * @param durationNs The duration in nanoseconds (the negative durations are recorded as 0)
+     */
+    void record(std::int64_t durationNs) {
+        if (index_ >= MAX_SITES) {
+            return;
+        }
+
+        local().recordSingleWriter(static_cast<std::uint64_t>(durationNs < 0 ? 0 : durationNs));
+    }
+
+    /**
+     * Adds the durations recorded by all the threads to the histogram.
+     *
+     * @param histogram The histogram to add to
+     */
+    void collect(Histogram &histogram) {
+        std::lock_guard lock{mutex_};
+
+        for (const auto &local : histograms_) {
+            local->addTo(histogram);
+        }
+    }
+
+    /**
+     * Forgets the durations recorded by all the threads.
+     */
+    void reset() {
+        std::lock_guard lock{mutex_};
+
+        for (const auto &local : histograms_) {
+            local->reset();
+        }
+    }
+};
+
+/**
+ * The RAII probe: records the time from the construction to the destruction into the site. The disabled probe
+ * (`ENABLED == false`) is empty and does nothing.
+ *
+ * @tparam ENABLED `true` if the probe records
+ */
+template <bool ENABLED> class BasicScopedProbe final {
+    ProbeSite &site_;
+    std::int64_t start_;
+
+  public:
+    /**
+     * @param site The site to record into
+     */
+    explicit BasicScopedProbe(ProbeSite &site) noexcept : site_{site}, start_{StopWatch::now()} {
+    }
+
+    BasicScopedProbe(const BasicScopedProbe &) = delete;
+    BasicScopedProbe &operator=(const BasicScopedProbe &) = delete;
+
+    ~BasicScopedProbe() {
+        site_.record(StopWatch::now() - start_);
+    }
+};
+
+template <> class BasicScopedProbe<false> final {
+  public:
+    explicit constexpr BasicScopedProbe(ProbeSite &) noexcept {
+    }
+
+    BasicScopedProbe(const BasicScopedProbe &) = delete;
+    BasicScopedProbe &operator=(const BasicScopedProbe &) = delete;
+};
+
+/// The probe of the build: compiles away unless the probes are enabled (see DSP_PROBES).
+using ScopedProbe = BasicScopedProbe<PROBES_ENABLED>;
+
+} // namespace dsp
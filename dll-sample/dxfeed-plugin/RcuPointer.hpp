@@ -0,0 +1,141 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include "EventArena.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace dsp {
+
+/**
+ * A pointer to an immutable object that is read without locks and replaced by copy-on-write (RCU-style).
+ *
+ * Readers enter a read-side section (RcuPointer::read()): they increment the reader counter of the current period
+ * parity and load the pointer. A writer swaps the pointer and retires the old object: it is destroyed once the period
+ * has advanced twice. The period advances (on a publication) only when the counter of the other parity is zero, so two
+ * advances mean that both counters have been zero after the retirement, i.e. every reader that could see the old object
+ * has left. Writers never wait for readers, so a reader may publish (e.g. a callback called during the dispatch).
+ *
+ * @tparam T The object type
+ */
+template <typename T> class RcuPointer final {
+    struct alignas(CACHE_LINE_SIZE) Counter {
+        std::atomic<std::uint64_t> readers{};
+    };
+
+    struct Retired {
+        std::unique_ptr<const T> value;
+        std::uint64_t period;
+    };
+
+    std::atomic<const T *> current_;
+    std::atomic<std::uint64_t> period_{};
+    mutable Counter counters_[2]{};
+
+    std::mutex mutex_{};
+    std::vector<Retired> retired_{};
+
+    // Advances the period if there are no readers that entered before the current period. Returns the period.
+    std::uint64_t tryAdvance() noexcept {
+        auto period = period_.load(std::memory_order_seq_cst);
+
+        if (counters_[(period + 1) & 1].readers.load(std::memory_order_seq_cst) != 0) {
+            return period;
+        }
+
+        period_.store(period + 1, std::memory_order_seq_cst);
+
+        return period + 1;
+    }
+
+  public:
+    /**
+     * The read-side section: the object stays alive until the guard is destroyed.
+     */
+    class ReadGuard final {
+        friend RcuPointer;
+
+        Counter *counter_;
+        const T *value_;
+
+        ReadGuard(Counter *counter, const T *value) noexcept : counter_{counter}, value_{value} {
+        }
+
+      public:
+        ReadGuard(const ReadGuard &) = delete;
+        ReadGuard &operator=(const ReadGuard &) = delete;
+
+        ~ReadGuard() {
+            counter_->readers.fetch_sub(1, std::memory_order_release);
+        }
+
+        const T *operator->() const noexcept {
+            return value_;
+        }
+
+        const T &operator*() const noexcept {
+            return *value_;
+        }
+    };
+
+    /**
+     * @param value The initial object
+     */
+    explicit RcuPointer(std::unique_ptr<const T> value) : current_{value.release()} {
+    }
+
+    RcuPointer(const RcuPointer &) = delete;
+    RcuPointer &operator=(const RcuPointer &) = delete;
+
+    /**
+     * Destroys the objects. There must be no readers.
+     */
+    ~RcuPointer() {
+        delete current_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Enters the read-side section (lock-free).
+     *
+     * @return The guard of the current object.
+     */
+    ReadGuard read() const noexcept {
+        auto &counter = counters_[period_.load(std::memory_order_seq_cst) & 1];
+
+        counter.readers.fetch_add(1, std::memory_order_seq_cst);
+
+        return ReadGuard{&counter, current_.load(std::memory_order_seq_cst)};
+    }
+
+    /**
+     * Replaces the object (never waits for readers). The old object is destroyed by a later publication, when the
+     * readers that may use it have left.
+     *
+     * @param value The new object
+     */
+    void publish(std::unique_ptr<const T> value) {
+        std::lock_guard lock{mutex_};
+
+        std::unique_ptr<const T> old{current_.exchange(value.release(), std::memory_order_seq_cst)};
+
+        retired_.push_back(Retired{std::move(old), period_.load(std::memory_order_seq_cst)});
+
+        tryAdvance();
+
+        auto period = tryAdvance();
+
+        std::erase_if(retired_, [period](const auto &retired) {
+            return retired.period + 2 <= period;
+        });
+    }
+};
+
+} // namespace dsp
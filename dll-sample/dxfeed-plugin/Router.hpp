@@ -0,0 +1,577 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <plugin-api.h>
+
+#include "RcuPointer.hpp"
+#include "Subscriber.hpp"
+#include "SymbolList.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace dsp {
+
+/**
+ * The per-symbol routing table: delivers every record of a batch only to the subscribers registered for the record's
+ * symbol and event type.
+ *
+ * Routes are found through an open-addressing (linear probing) hash table keyed by the symbol id, so the dispatch cost
+ * per record depends on the number of subscribers of the record's symbol, but not on the total number of symbols.
+ * Each subscriber receives all its records of a batch in one call.
+ *
+ * The registrations are rare and the dispatch is hot, so they are separated: the registrations modify the routes under
+ * a mutex and then publish an immutable, contiguous snapshot of them (Router::Table) through an atomic pointer swap
+ * (RcuPointer). The dispatch reads the current snapshot without locks, so several threads dispatch concurrently and a
+ * callback may change the routes while its batch is being delivered. Every change publishes a new snapshot, so the
+ * bulk changes are made in one Router::update() call. The frequent single changes are made by Router::defer() and
+ * published together by Router::flush(), so N of them rebuild the snapshot once and not N times.
+ */
+class Router final {
+    static constexpr std::uint32_t EMPTY = static_cast<std::uint32_t>(-1);
+    static constexpr std::size_t INITIAL_CAPACITY = 64;
+
+    struct Target {
+        Subscriber *subscriber;
+        dsp_event_type_mask_t eventTypes;
+    };
+
+    /**
+     * The immutable snapshot of the routes the dispatch reads. The routes are bucketed by the event type: a bucket has
+     * only the symbols with subscribers of its type and only these subscribers, so the dispatch finds the subscribers
+     * of a record in the bucket of its type and does not check the event types of the subscribers. The targets of all
+     * the symbols of a bucket are stored in one array, a slot refers to the range of the targets of its symbol.
+     */
+    struct Table {
+        struct Slot {
+            std::uint32_t symbolId = EMPTY;
+            std::uint32_t begin = 0;
+            std::uint32_t end = 0;
+        };
+
+        struct Bucket {
+            std::vector<Slot> slots = std::vector<Slot>(INITIAL_CAPACITY);
+            // The indices in Table::subscribers
+            std::vector<std::uint32_t> targets{};
+
+            const Slot *find(std::uint32_t symbolId) const noexcept {
+                auto mask = slots.size() - 1;
+
+                for (auto i = slotIndex(symbolId, mask);; i = (i + 1) & mask) {
+                    if (slots[i].symbolId == symbolId) {
+                        return &slots[i];
+                    }
+
+                    if (slots[i].symbolId == EMPTY) {
+                        return nullptr;
+                    }
+                }
+            }
+        };
+
+        // dsp_event_type_t -> bucket
+        std::array<Bucket, DSP_ET_COUNT> buckets{};
+        // The subscribers are kept alive while the snapshot is read.
+        std::vector<std::shared_ptr<Subscriber>> subscribers{};
+    };
+
+    /**
+     * The per-thread state of the dispatch: the indices of the records addressed to every subscriber of the snapshot.
+     */
+    struct Scratch {
+        std::vector<std::vector<std::uint32_t>> indices{};
+        std::vector<std::uint32_t> touched{};
+    };
+
+    // symbol id -> the targets
+    std::unordered_map<std::uint32_t, std::vector<Target>> routes_{};
+    std::vector<std::shared_ptr<Subscriber>> subscribers_{};
+    // subscriber -> the ids of the symbols routed to it
+    std::unordered_map<const Subscriber *, std::unordered_set<std::uint32_t>> symbolIds_{};
+    std::recursive_mutex mutex_{};
+    std::size_t updates_{};
+    bool changed_{};
+
+    RcuPointer<Table> table_{std::make_unique<const Table>()};
+
+    // The multiplication by an odd constant is a bijection, so dense ids are spread without collisions.
+    static std::size_t slotIndex(std::uint32_t symbolId, std::size_t mask) noexcept {
+        return static_cast<std::size_t>(symbolId * 0x9E3779B1U) & mask;
+    }
+
+    static Scratch &getScratch() noexcept {
+        thread_local Scratch scratch{};
+
+        return scratch;
+    }
+
+    static dsp_event_type_mask_t eventTypesOf(const std::vector<Target> &targets) noexcept {
+        dsp_event_type_mask_t eventTypes = 0;
+
+        for (const auto &target : targets) {
+            eventTypes |= target.eventTypes;
+        }
+
+        return eventTypes;
+    }
+
+    // Builds the snapshot of the routes (the subscribers that receive nothing are left out).
+    std::unique_ptr<const Table> buildTable() const {
+        auto table = std::make_unique<Table>();
+        std::unordered_map<const Subscriber *, std::uint32_t> indices{};
+
+        for (const auto &subscriber : subscribers_) {
+            if (subscriber->getKind() != Subscriber::Kind::SNAPSHOT) {
+                indices.emplace(subscriber.get(), static_cast<std::uint32_t>(table->subscribers.size()));
+                table->subscribers.push_back(subscriber);
+            }
+        }
+
+        std::array<std::size_t, DSP_ET_COUNT> symbolCounts{};
+
+        for (const auto &[symbolId, targets] : routes_) {
+            auto eventTypes = eventTypesOf(targets);
+
+            for (std::size_t eventType = 0; eventType < DSP_ET_COUNT; eventType++) {
+                symbolCounts[eventType] += (eventTypes & DSP_EVENT_TYPE_MASK(eventType)) != 0;
+            }
+        }
+
+        for (std::size_t eventType = 0; eventType < DSP_ET_COUNT; eventType++) {
+            std::size_t capacity = INITIAL_CAPACITY;
+
+            // Keep the table at most half full.
+            while (symbolCounts[eventType] * 2 > capacity) {
+                capacity *= 2;
+            }
+
+            table->buckets[eventType].slots.resize(capacity);
+        }
+
+        for (const auto &[symbolId, targets] : routes_) {
+            auto eventTypes = eventTypesOf(targets);
+
+            for (std::size_t eventType = 0; eventType < DSP_ET_COUNT; eventType++) {
+                auto eventTypeMask = DSP_EVENT_TYPE_MASK(eventType);
+
+                if ((eventTypes & eventTypeMask) == 0) {
+                    continue;
+                }
+
+                auto &bucket = table->buckets[eventType];
+                auto begin = static_cast<std::uint32_t>(bucket.targets.size());
+
+                for (const auto &target : targets) {
+                    if ((target.eventTypes & eventTypeMask) == 0) {
+                        continue;
+                    }
+
+                    if (auto index = indices.find(target.subscriber); index != indices.end()) {
+                        bucket.targets.push_back(index->second);
+                    }
+                }
+
+                auto end = static_cast<std::uint32_t>(bucket.targets.size());
+
+                if (begin == end) {
+                    continue;
+                }
+
+                auto mask = bucket.slots.size() - 1;
+
+                for (auto i = slotIndex(symbolId, mask);; i = (i + 1) & mask) {
+                    if (bucket.slots[i].symbolId == EMPTY) {
+                        bucket.slots[i] = Table::Slot{symbolId, begin, end};
+
+                        break;
+                    }
+                }
+            }
+        }
+
+        return table;
+    }
+
+    // Publishes the changed routes unless they are being changed by Router::update().
+    void publish() {
+        if (updates_ != 0 || !changed_) {
+            return;
+        }
+
+        changed_ = false;
+        table_.publish(buildTable());
+    }
+
+  public:
+    /**
+     * The change of the event types of a symbol requested by all its subscribers.
+     */
+    struct Change {
+        /// The event types nobody subscribed to before
+        dsp_event_type_mask_t added;
+        /// The event types nobody subscribes to anymore
+        dsp_event_type_mask_t removed;
+    };
+
+    Router() = default;
+    Router(const Router &) = delete;
+    Router &operator=(const Router &) = delete;
+
+    /**
+     * Registers the subscriber. The router owns the subscriber from now on. If the same consumer is already registered
+     * (Subscriber::isSameAs()), the new subscriber is dropped and the registered one is returned.
+     *
+     * @param subscriber The subscriber
+     * @return The pointer to the subscriber to be used with Router::setRoute().
+     */
+    Subscriber *addSubscriber(std::unique_ptr<Subscriber> subscriber) {
+        std::lock_guard guard{mutex_};
+
+        if (auto *registered = findSubscriber(*subscriber); registered != nullptr) {
+            return registered;
+        }
+
+        // The subscriber has no routes yet, so the snapshot is not changed.
+        return subscribers_.emplace_back(std::move(subscriber)).get();
+    }
+
+    /**
+     * @param probe The subscriber describing the consumer
+     * @return The registered subscriber of the same consumer (Subscriber::isSameAs()) or `nullptr`.
+     */
+    Subscriber *findSubscriber(const Subscriber &probe) {
+        std::lock_guard guard{mutex_};
+
+        auto found = std::find_if(subscribers_.begin(), subscribers_.end(), [&probe](const auto &subscriber) {
+            return subscriber->isSameAs(probe);
+        });
+
+        return found == subscribers_.end() ? nullptr : found->get();
+    }
+
+    /**
+     * Makes the changes of the routes in the function and publishes them at once.
+     *
+     * @param function The function that changes the routes: `void()`
+     */
+    template <typename Function> void update(Function &&function) {
+        std::lock_guard guard{mutex_};
+
+        updates_++;
+
+        try {
+            function();
+        } catch (...) {
+            updates_--;
+            publish();
+
+            throw;
+        }
+
+        updates_--;
+        publish();
+    }
+
+    /**
+     * Makes the changes of the routes in the function, but does not publish them: they are published by the next
+     * Router::flush() or with the next published change.
+     *
+     * @param function The function that changes the routes: `void()`
+     */
+    template <typename Function> void defer(Function &&function) {
+        std::lock_guard guard{mutex_};
+
+        updates_++;
+
+        try {
+            function();
+        } catch (...) {
+            updates_--;
+
+            throw;
+        }
+
+        updates_--;
+    }
+
+    /**
+     * Publishes the changes deferred by Router::defer(), if any.
+     */
+    void flush() {
+        std::lock_guard guard{mutex_};
+
+        publish();
+    }
+
+    /**
+     * Sets the event types of the symbol that are routed to the subscriber.
+     *
+     * @param symbolId The symbol id
+     * @param subscriber The subscriber
+     * @param eventTypes The event types or 0 to remove the route
+     * @return The change of the event types of the symbol.
+     */
+    Change setRoute(std::uint32_t symbolId, Subscriber *subscriber, dsp_event_type_mask_t eventTypes) {
+        std::lock_guard guard{mutex_};
+
+        auto route = routes_.find(symbolId);
+
+        if (route == routes_.end()) {
+            if (eventTypes == 0) {
+                return {};
+            }
+
+            route = routes_.emplace(symbolId, std::vector<Target>{}).first;
+        }
+
+        auto &targets = route->second;
+        auto before = eventTypesOf(targets);
+        auto target = std::find_if(targets.begin(), targets.end(), [subscriber](const auto &t) {
+            return t.subscriber == subscriber;
+        });
+
+        if (eventTypes == 0) {
+            if (target != targets.end()) {
+                targets.erase(target);
+
+                // A subscriber without symbols has no entry (see Router::removeSubscriberIfUnused()).
+                if (auto ids = symbolIds_.find(subscriber); ids != symbolIds_.end()) {
+                    ids->second.erase(symbolId);
+
+                    if (ids->second.empty()) {
+                        symbolIds_.erase(ids);
+                    }
+                }
+            }
+        } else if (target != targets.end()) {
+            target->eventTypes = eventTypes;
+        } else {
+            targets.push_back(Target{subscriber, eventTypes});
+            symbolIds_[subscriber].insert(symbolId);
+        }
+
+        auto after = eventTypesOf(targets);
+
+        if (targets.empty()) {
+            routes_.erase(route);
+        }
+
+        changed_ = true;
+        publish();
+
+        return {after & ~before, before & ~after};
+    }
+
+    /**
+     * Routes the event types of the symbol to the subscriber in addition to the already routed ones.
+     *
+     * @param symbolId The symbol id
+     * @param subscriber The subscriber
+     * @param eventTypes The event types
+     * @return The change of the event types of the symbol.
+     */
+    Change addRoute(std::uint32_t symbolId, Subscriber *subscriber, dsp_event_type_mask_t eventTypes) {
+        std::lock_guard guard{mutex_};
+
+        return setRoute(symbolId, subscriber, eventTypes | getRoute(symbolId, subscriber));
+    }
+
+    /**
+     * Stops routing the records of the symbol to the subscriber.
+     *
+     * @param symbolId The symbol id
+     * @param subscriber The subscriber
+     * @return The change of the event types of the symbol.
+     */
+    Change removeRoute(std::uint32_t symbolId, Subscriber *subscriber) {
+        return setRoute(symbolId, subscriber, 0);
+    }
+
+    /**
+     * Replaces the symbols routed to the subscriber: only the difference with the current routes is applied (in one
+     * Router::update()).
+     *
+     * @param subscriber The subscriber
+     * @param symbolIds The sorted unique ids of the symbols (see SymbolList)
+     * @param eventTypes The event types
+     * @param onChange The function called with the change of the event types of every changed symbol:
+     *                 `void(std::uint32_t symbolId, Change change)`
+     */
+    template <typename OnChange>
+    void setRoutes(Subscriber *subscriber, const std::vector<std::uint32_t> &symbolIds,
+                   dsp_event_type_mask_t eventTypes, OnChange &&onChange) {
+        update([&] {
+            auto current = getSymbolIds(subscriber);
+
+            std::sort(current.begin(), current.end());
+            SymbolList::diff(
+                current, symbolIds,
+                [&](std::uint32_t symbolId) {
+                    onChange(symbolId, setRoute(symbolId, subscriber, 0));
+                },
+                [&](std::uint32_t symbolId) {
+                    onChange(symbolId, setRoute(symbolId, subscriber, eventTypes));
+                },
+                [&](std::uint32_t symbolId) {
+                    if (getRoute(symbolId, subscriber) != eventTypes) {
+                        onChange(symbolId, setRoute(symbolId, subscriber, eventTypes));
+                    }
+                });
+        });
+    }
+
+    /**
+     * @param symbolId The symbol id
+     * @param subscriber The subscriber
+     * @return The event types of the symbol routed to the subscriber.
+     */
+    dsp_event_type_mask_t getRoute(std::uint32_t symbolId, const Subscriber *subscriber) {
+        std::lock_guard guard{mutex_};
+
+        if (auto route = routes_.find(symbolId); route != routes_.end()) {
+            for (const auto &target : route->second) {
+                if (target.subscriber == subscriber) {
+                    return target.eventTypes;
+                }
+            }
+        }
+
+        return 0;
+    }
+
+    /**
+     * Locks the routes: no routes are changed until the lock is released (the dispatch goes on).
+     *
+     * @return The lock.
+     */
+    std::unique_lock<std::recursive_mutex> lock() {
+        return std::unique_lock{mutex_};
+    }
+
+    /**
+     * Calls the function with every routed symbol and the event types routed to all its subscribers.
+     *
+     * @param function The function: `void(std::uint32_t symbolId, dsp_event_type_mask_t eventTypes)`
+     */
+    template <typename Function> void forEachSymbol(Function &&function) {
+        std::lock_guard guard{mutex_};
+
+        for (const auto &[symbolId, targets] : routes_) {
+            function(symbolId, eventTypesOf(targets));
+        }
+    }
+
+    /**
+     * @param subscriber The subscriber
+     * @return The ids of the symbols routed to the subscriber.
+     */
+    std::vector<std::uint32_t> getSymbolIds(const Subscriber *subscriber) {
+        std::lock_guard guard{mutex_};
+
+        auto found = symbolIds_.find(subscriber);
+
+        if (found == symbolIds_.end()) {
+            return {};
+        }
+
+        return {found->second.begin(), found->second.end()};
+    }
+
+    /**
+     * Unregisters the subscriber. The subscriber must have no routes (see Router::removeRoute()). It is destroyed when
+     * the last snapshot that refers to it is no longer read (it may be removed by a callback while a batch is being
+     * delivered to it).
+     *
+     * @param subscriber The subscriber
+     */
+    void removeSubscriber(Subscriber *subscriber) {
+        std::lock_guard guard{mutex_};
+
+        symbolIds_.erase(subscriber);
+        std::erase_if(subscribers_, [subscriber](const auto &registered) {
+            return registered.get() == subscriber;
+        });
+        changed_ = true;
+        publish();
+    }
+
+    /**
+     * Unregisters the subscriber if no symbols are routed to it anymore (see Router::removeSubscriber()), so the
+     * consumers that unsubscribed from all their symbols do not accumulate.
+     *
+     * @param subscriber The subscriber
+     * @return `true` if the subscriber was unregistered.
+     */
+    bool removeSubscriberIfUnused(Subscriber *subscriber) {
+        std::lock_guard guard{mutex_};
+
+        if (symbolIds_.contains(subscriber)) {
+            return false;
+        }
+
+        removeSubscriber(subscriber);
+
+        return true;
+    }
+
+    /**
+     * Delivers the records of the batch to the subscribers of their symbols. Lock-free, may be called by several
+     * threads concurrently, but must not be reentered from a callback.
+     *
+     * @param records The records
+     * @param size The number of records
+     */
+    void dispatch(const dsp_event_record_t *records, std::size_t size) const {
+        auto table = table_.read();
+        auto &scratch = getScratch();
+
+        if (scratch.indices.size() < table->subscribers.size()) {
+            scratch.indices.resize(table->subscribers.size());
+        }
+
+        for (std::size_t i = 0; i < size; i++) {
+            auto eventType = static_cast<std::size_t>(records[i].event.type);
+
+            if (eventType >= DSP_ET_COUNT) {
+                continue;
+            }
+
+            const auto &bucket = table->buckets[eventType];
+            const auto *slot = bucket.find(records[i].event.symbol_id);
+
+            if (slot == nullptr) {
+                continue;
+            }
+
+            for (auto t = slot->begin; t < slot->end; t++) {
+                auto subscriber = bucket.targets[t];
+                auto &indices = scratch.indices[subscriber];
+
+                if (indices.empty()) {
+                    scratch.touched.push_back(subscriber);
+                }
+
+                indices.push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+
+        // The callbacks may change the routes: the snapshot being read stays intact.
+        for (auto subscriber : scratch.touched) {
+            table->subscribers[subscriber]->deliver(records, size, scratch.indices[subscriber]);
+            scratch.indices[subscriber].clear();
+        }
+
+        scratch.touched.clear();
+    }
+};
+
+} // namespace dsp
@@ -0,0 +1,80 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace dsp {
+
+/**
+ * The registry of elements indexed by dense ids: an array of atomic pointers to fixed-size segments.
+ *
+ * The lookup (SegmentedArray::find()) is wait-free: one atomic load of the segment pointer and an index, no locks and
+ * no hashing, so any number of threads look the elements up concurrently. The segments are allocated lazily under a
+ * mutex (SegmentedArray::findOrAllocate()) and are never moved or freed until the array is destroyed, so the pointers
+ * to the elements stay valid.
+ *
+ * @tparam T The element type (default constructible)
+ * @tparam SEGMENT_SIZE The number of elements in a segment
+ * @tparam MAX_SEGMENTS The maximal number of segments
+ */
+template <typename T, std::size_t SEGMENT_SIZE = 4096, std::size_t MAX_SEGMENTS = 4096> class SegmentedArray final {
+    std::array<std::atomic<T *>, MAX_SEGMENTS> segments_{};
+
+    std::mutex mutex_{};
+    std::vector<std::unique_ptr<T[]>> ownedSegments_{};
+
+  public:
+    /// The maximal number of elements (all the ids are less than this number).
+    static constexpr std::size_t MAX_SIZE = SEGMENT_SIZE * MAX_SEGMENTS;
+
+    SegmentedArray() = default;
+    SegmentedArray(const SegmentedArray &) = delete;
+    SegmentedArray &operator=(const SegmentedArray &) = delete;
+
+    /**
+     * Returns the element (wait-free).
+     *
+     * @param id The id
+     * @return The element or `nullptr` if its segment has not been allocated.
+     */
+    T *find(std::size_t id) const noexcept {
+        if (id >= MAX_SIZE) {
+            return nullptr;
+        }
+
+        auto *segment = segments_[id / SEGMENT_SIZE].load(std::memory_order_acquire);
+
+        return segment == nullptr ? nullptr : &segment[id % SEGMENT_SIZE];
+    }
+
+    /**
+     * Returns the element and allocates its segment if needed.
+     *
+     * @param id The id
+     * @return The element or `nullptr` if the id is not less than SegmentedArray::MAX_SIZE.
+     */
+    T *findOrAllocate(std::size_t id) {
+        if (auto *element = find(id); element != nullptr || id >= MAX_SIZE) {
+            return element;
+        }
+
+        std::lock_guard lock{mutex_};
+        auto &segment = segments_[id / SEGMENT_SIZE];
+
+        if (segment.load(std::memory_order_relaxed) == nullptr) {
+            ownedSegments_.emplace_back(std::make_unique<T[]>(SEGMENT_SIZE));
+            segment.store(ownedSegments_.back().get(), std::memory_order_release);
+        }
+
+        return &segment.load(std::memory_order_relaxed)[id % SEGMENT_SIZE];
+    }
+};
+
+} // namespace dsp
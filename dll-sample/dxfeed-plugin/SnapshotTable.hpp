@@ -0,0 +1,164 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <plugin-api.h>
+
+#include "EventArena.hpp"
+#include "SegmentedArray.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace dsp {
+
+/**
+ * A value guarded by a sequence lock: one writer at a time, any number of readers that never block the writer.
+ *
+ * The sequence is odd while the value is being written. A reader copies the value between two loads of the sequence
+ * and retries if the sequence changed or was odd. The value is stored as relaxed atomic words, so the concurrent copies
+ * are not data races. The sequence is 64-bit: it doesn't wrap back to 0 ("never written") in the lifetime of a process.
+ *
+ * @tparam T The value type
+ */
+template <typename T> class Seqlock final {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    static constexpr std::size_t WORDS = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    std::atomic<std::uint64_t> sequence_{};
+    std::array<std::atomic<std::uint64_t>, WORDS> words_{};
+
+  public:
+    /**
+     * Writes the value (one writer at a time).
+     *
+     * @param value The value
+     */
+    void write(const T &value) noexcept {
+        std::array<std::uint64_t, WORDS> words{};
+
+        std::memcpy(words.data(), &value, sizeof(T));
+
+        auto sequence = sequence_.load(std::memory_order_relaxed);
+
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (std::size_t i = 0; i < WORDS; i++) {
+            words_[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * Reads the consistent value (any thread). Retries only while a write is in progress.
+     *
+     * @param value The destination
+     * @return `false` if the value has never been written.
+     */
+    bool read(T &value) const noexcept {
+        std::array<std::uint64_t, WORDS> words{};
+        std::uint64_t sequence{};
+
+        do {
+            sequence = sequence_.load(std::memory_order_acquire);
+
+            if (sequence == 0) {
+                return false;
+            }
+
+            for (std::size_t i = 0; i < WORDS; i++) {
+                words[i] = words_[i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((sequence & 1) != 0 || sequence != sequence_.load(std::memory_order_relaxed));
+
+        std::memcpy(&value, words.data(), sizeof(T));
+
+        return true;
+    }
+};
+
+/**
+ * The conflated last-value table: the latest quote and trade of every symbol, indexed by the symbol id.
+ *
+ * The feed thread writes every marshaled record to the slot of its symbol, so a consumer that only needs the current
+ * values reads them at any time from any thread, without callbacks. The quote and the trade of a symbol are guarded by
+ * separate seqlocks on separate cache lines. The slots are allocated in fixed-size segments that are never moved
+ * (SegmentedArray).
+ */
+class SnapshotTable final {
+    struct Slot {
+        alignas(CACHE_LINE_SIZE) Seqlock<dsp_quote_t> quote{};
+        alignas(CACHE_LINE_SIZE) Seqlock<dsp_trade_t> trade{};
+    };
+
+    SegmentedArray<Slot> slots_{};
+
+  public:
+    SnapshotTable() = default;
+    SnapshotTable(const SnapshotTable &) = delete;
+    SnapshotTable &operator=(const SnapshotTable &) = delete;
+
+    /**
+     * Stores the records as the latest values of their symbols. The records of one symbol and type must not be
+     * updated concurrently.
+     *
+     * @param records The records
+     * @param size The number of records
+     */
+    void update(const dsp_event_record_t *records, std::size_t size) {
+        for (std::size_t i = 0; i < size; i++) {
+            auto eventType = records[i].event.type;
+
+            // The other types have no snapshots, their symbols don't need slots.
+            if (eventType != DSP_ET_QUOTE && eventType != DSP_ET_TRADE) {
+                continue;
+            }
+
+            auto *slot = slots_.findOrAllocate(records[i].event.symbol_id);
+
+            if (slot == nullptr) {
+                continue;
+            }
+
+            if (eventType == DSP_ET_QUOTE) {
+                slot->quote.write(records[i].quote);
+            } else {
+                slot->trade.write(records[i].trade);
+            }
+        }
+    }
+
+    /**
+     * @param symbolId The symbol id
+     * @param quote The destination
+     * @return `true` if the quote of the symbol has been received.
+     */
+    bool readQuote(std::uint32_t symbolId, dsp_quote_t &quote) const noexcept {
+        const auto *slot = slots_.find(symbolId);
+
+        return slot != nullptr && slot->quote.read(quote);
+    }
+
+    /**
+     * @param symbolId The symbol id
+     * @param trade The destination
+     * @return `true` if the trade of the symbol has been received.
+     */
+    bool readTrade(std::uint32_t symbolId, dsp_trade_t &trade) const noexcept {
+        const auto *slot = slots_.find(symbolId);
+
+        return slot != nullptr && slot->trade.read(trade);
+    }
+};
+
+} // namespace dsp
@@ -0,0 +1,142 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include "EventArena.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+namespace dsp {
+
+/**
+ * A bounded lock-free single-producer/single-consumer ring buffer.
+ *
+ * The producer and the consumer indices live on separate cache lines, and each side keeps a cached copy of the other
+ * side's index, so in the steady state a push or a pop touches the shared index of the other side only when the cached
+ * copy says the ring is full (empty). Every slot occupies whole cache lines.
+ *
+ * Exactly one thread may push and exactly one thread may pop at a time (the threads may change, if the change is
+ * synchronized externally).
+ *
+ * @tparam T The item type
+ */
+template <typename T> class SpscRing final {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        T value;
+    };
+
+    std::size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    // The consumer side
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head_{};
+    std::size_t cachedTail_{};
+
+    // The producer side
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail_{};
+    std::size_t cachedHead_{};
+
+    static std::size_t roundUpToPowerOfTwo(std::size_t capacity) {
+        if (capacity > MAX_CAPACITY) {
+            throw std::length_error("The capacity of the ring is too large");
+        }
+
+        return std::bit_ceil(std::max<std::size_t>(capacity, 1));
+    }
+
+  public:
+    /// The largest capacity: the largest power of two whose slots fit in the address space.
+    static constexpr std::size_t MAX_CAPACITY = std::bit_floor(std::numeric_limits<std::size_t>::max() / sizeof(Slot));
+
+    /**
+     * @param capacity The minimal capacity (rounded up to a power of two)
+     * @throws std::length_error if the capacity is greater than MAX_CAPACITY
+     */
+    explicit SpscRing(std::size_t capacity)
+        : mask_{roundUpToPowerOfTwo(capacity) - 1},
+          slots_{std::make_unique_for_overwrite<Slot[]>(mask_ + 1)} {
+    }
+
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    /**
+     * Pushes as many of the items as fit into the ring (producer only).
+     *
+     * @param count The number of items
+     * @param item The function that returns the i-th item: `const T &(std::size_t i)`
+     * @return The number of pushed items (the first ones).
+     */
+    template <typename Item> std::size_t push(std::size_t count, Item &&item) noexcept {
+        auto tail = tail_.load(std::memory_order_relaxed);
+        auto capacity = mask_ + 1;
+
+        if (capacity - (tail - cachedHead_) < count) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+        }
+
+        auto pushed = std::min(count, capacity - (tail - cachedHead_));
+
+        for (std::size_t i = 0; i < pushed; i++) {
+            slots_[(tail + i) & mask_].value = item(i);
+        }
+
+        tail_.store(tail + pushed, std::memory_order_release);
+
+        return pushed;
+    }
+
+    /**
+     * Pops up to `maxCount` items (consumer only).
+     *
+     * @param items The buffer for the items
+     * @param maxCount The buffer size
+     * @return The number of popped items.
+     */
+    std::size_t pop(T *items, std::size_t maxCount) noexcept {
+        auto head = head_.load(std::memory_order_relaxed);
+
+        if (cachedTail_ - head < maxCount) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+        }
+
+        auto popped = std::min(maxCount, cachedTail_ - head);
+
+        for (std::size_t i = 0; i < popped; i++) {
+            items[i] = slots_[(head + i) & mask_].value;
+        }
+
+        head_.store(head + popped, std::memory_order_release);
+
+        return popped;
+    }
+
+    /**
+     * @return The number of items in the ring (exact only when called by the producer or the consumer while the other
+     *         side is idle).
+     */
+    std::size_t size() const noexcept {
+        auto head = head_.load(std::memory_order_acquire);
+
+        return tail_.load(std::memory_order_acquire) - head;
+    }
+
+    /**
+     * @return The capacity of the ring.
+     */
+    std::size_t capacity() const noexcept {
+        return mask_ + 1;
+    }
+};
+
+} // namespace dsp
@@ -0,0 +1,98 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace dsp {
+
+/**
+ * The lock-free stopwatch with the nanosecond resolution.
+ *
+ * Unlike the StopWatch of the SDK (milliseconds, a mutex per call), starting and stopping it is a clock read and a
+ * couple of relaxed atomic stores, so it can time the sub-microsecond sections of the hot path. The stopwatch is
+ * started and stopped by one thread; other threads may read StopWatch::elapsed() concurrently (the value read during
+ * StopWatch::start() or StopWatch::stop() may miss the current period).
+ */
+class StopWatch final {
+    static constexpr std::int64_t NOT_RUNNING = -1;
+
+    // The elapsed time of the finished periods.
+    std::atomic<std::int64_t> elapsed_{};
+    // The start of the current period or NOT_RUNNING.
+    std::atomic<std::int64_t> start_{NOT_RUNNING};
+
+  public:
+    /**
+     * @return The current time of the monotonic clock in nanoseconds (since an unspecified point).
+     */
+    static std::int64_t now() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    StopWatch() = default;
+    StopWatch(const StopWatch &) = delete;
+    StopWatch &operator=(const StopWatch &) = delete;
+
+    /**
+     * Starts a new period unless the stopwatch is running.
+     */
+    void start() noexcept {
+        if (!isRunning()) {
+            start_.store(now(), std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Adds the current period to the elapsed time and stops the stopwatch.
+     */
+    void stop() noexcept {
+        if (auto start = start_.load(std::memory_order_relaxed); start != NOT_RUNNING) {
+            elapsed_.store(elapsed_.load(std::memory_order_relaxed) + now() - start, std::memory_order_relaxed);
+            start_.store(NOT_RUNNING, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Stops the stopwatch and resets the elapsed time.
+     */
+    void reset() noexcept {
+        start_.store(NOT_RUNNING, std::memory_order_relaxed);
+        elapsed_.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * Resets the elapsed time and starts a new period.
+     */
+    void restart() noexcept {
+        elapsed_.store(0, std::memory_order_relaxed);
+        start_.store(now(), std::memory_order_relaxed);
+    }
+
+    /**
+     * @return `true` if the stopwatch is running.
+     */
+    bool isRunning() const noexcept {
+        return start_.load(std::memory_order_relaxed) != NOT_RUNNING;
+    }
+
+    /**
+     * @return The elapsed time of the finished periods and of the current one.
+     */
+    std::chrono::nanoseconds elapsed() const noexcept {
+        auto elapsed = elapsed_.load(std::memory_order_relaxed);
+
+        if (auto start = start_.load(std::memory_order_relaxed); start != NOT_RUNNING) {
+            elapsed += now() - start;
+        }
+
+        return std::chrono::nanoseconds{elapsed};
+    }
+};
+
+} // namespace dsp
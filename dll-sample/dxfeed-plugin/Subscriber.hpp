@@ -0,0 +1,227 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <plugin-api.h>
+
+#include "EventArena.hpp"
+#include "EventQueue.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace dsp {
+
+/**
+ * The consumer registered by one of the `dsp_subscribe*` functions (the callback, its user data and the format in which
+ * the callback receives the events) or by `dsp_open_queue` (the queue the events are copied to).
+ *
+ * The router collects the indices of the batch records addressed to the subscriber and then delivers them in one call
+ * (Subscriber::deliver()). Every subscriber owns an arena for the data it hands out, so the delivery does not allocate
+ * in the steady state. The batches may be dispatched by several threads, the deliveries to one subscriber are
+ * serialized, so its callback is never called concurrently.
+ */
+class Subscriber final {
+  public:
+    enum class Kind {
+        EVENTS,
+        RECORDS,
+        COLUMNS,
+        QUEUE,
+        // Only keeps the symbols subscribed for the snapshot table, receives nothing.
+        SNAPSHOT,
+    };
+
+    /// The event types of the columnar view (dsp_quote_columns_t and dsp_trade_columns_t), the only ones a COLUMNS
+    /// subscriber is routed.
+    static constexpr dsp_event_type_mask_t COLUMNS_EVENT_TYPES = DSP_EVENT_TYPE_MASK_DEFAULT;
+
+  private:
+    Kind kind_;
+    dsp_events_listener_t eventsListener_{};
+    dsp_records_listener_t recordsListener_{};
+    dsp_columns_listener_t columnsListener_{};
+    std::shared_ptr<EventQueue> queue_{};
+    void *userData_;
+
+    std::mutex mutex_{};
+    EventArena arena_{};
+
+    Subscriber(Kind kind, void *userData) noexcept : kind_{kind}, userData_{userData} {
+    }
+
+    static constexpr std::size_t columnsBytesFor(std::size_t size) noexcept {
+        // 4 + 3 double columns and a symbol id column per event type
+        return 7 * EventArena::bytesFor<double, CACHE_LINE_SIZE>(size) +
+               2 * EventArena::bytesFor<std::uint32_t, CACHE_LINE_SIZE>(size);
+    }
+
+    void deliverEvents(const dsp_event_record_t *records, const std::vector<std::uint32_t> &indices) {
+        arena_.reset(EventArena::bytesFor<dsp_event_t *>(indices.size()));
+
+        auto *events = arena_.allocateArray<dsp_event_t *>(indices.size());
+
+        for (std::size_t i = 0; i < indices.size(); i++) {
+            // The records are not modified by consumers, the pointer type is kept for compatibility.
+            events[i] = const_cast<dsp_event_t *>(&records[indices[i]].event);
+        }
+
+        eventsListener_(events, indices.size(), userData_);
+    }
+
+    void deliverRecords(const dsp_event_record_t *records, std::size_t size,
+                        const std::vector<std::uint32_t> &indices) {
+        // The indices are unique and ascending, so if there are as many of them as records, it is the whole batch, and
+        // it is handed out as is.
+        if (indices.size() == size) {
+            recordsListener_(records, size, userData_);
+
+            return;
+        }
+
+        arena_.reset(EventArena::bytesFor<dsp_event_record_t, CACHE_LINE_SIZE>(indices.size()));
+
+        auto *subset = arena_.allocateArray<dsp_event_record_t, CACHE_LINE_SIZE>(indices.size());
+
+        for (std::size_t i = 0; i < indices.size(); i++) {
+            subset[i] = records[indices[i]];
+        }
+
+        recordsListener_(subset, indices.size(), userData_);
+    }
+
+    // Only the quotes and trades have columns (COLUMNS_EVENT_TYPES), the subscriber is not routed the other types.
+    void deliverColumns(const dsp_event_record_t *records, const std::vector<std::uint32_t> &indices) {
+        auto size = indices.size();
+
+        arena_.reset(columnsBytesFor(size));
+
+        auto *quoteSymbolId = arena_.allocateArray<std::uint32_t, CACHE_LINE_SIZE>(size);
+        auto *bidPrice = arena_.allocateArray<double, CACHE_LINE_SIZE>(size);
+        auto *bidSize = arena_.allocateArray<double, CACHE_LINE_SIZE>(size);
+        auto *askPrice = arena_.allocateArray<double, CACHE_LINE_SIZE>(size);
+        auto *askSize = arena_.allocateArray<double, CACHE_LINE_SIZE>(size);
+        auto *tradeSymbolId = arena_.allocateArray<std::uint32_t, CACHE_LINE_SIZE>(size);
+        auto *price = arena_.allocateArray<double, CACHE_LINE_SIZE>(size);
+        auto *tradeSize = arena_.allocateArray<double, CACHE_LINE_SIZE>(size);
+        auto *dayVolume = arena_.allocateArray<double, CACHE_LINE_SIZE>(size);
+
+        std::size_t quotes = 0;
+        std::size_t trades = 0;
+
+        for (auto index : indices) {
+            const auto &record = records[index];
+
+            if (record.event.type == DSP_ET_QUOTE) {
+                quoteSymbolId[quotes] = record.event.symbol_id;
+                bidPrice[quotes] = record.quote.bid_price;
+                bidSize[quotes] = record.quote.bid_size;
+                askPrice[quotes] = record.quote.ask_price;
+                askSize[quotes] = record.quote.ask_size;
+                quotes++;
+            } else if (record.event.type == DSP_ET_TRADE) {
+                tradeSymbolId[trades] = record.event.symbol_id;
+                price[trades] = record.trade.price;
+                tradeSize[trades] = record.trade.size;
+                dayVolume[trades] = record.trade.dayVolume;
+                trades++;
+            }
+        }
+
+        auto quoteColumns = dsp_quote_columns_t{quotes, bidPrice, bidSize, askPrice, askSize, quoteSymbolId};
+        auto tradeColumns = dsp_trade_columns_t{trades, price, tradeSize, dayVolume, tradeSymbolId};
+
+        columnsListener_(&quoteColumns, &tradeColumns, userData_);
+    }
+
+  public:
+    Subscriber(const Subscriber &) = delete;
+    Subscriber &operator=(const Subscriber &) = delete;
+
+    static std::unique_ptr<Subscriber> events(dsp_events_listener_t listener, void *userData) {
+        auto subscriber =
+            std::unique_ptr<Subscriber>(new Subscriber(listener == nullptr ? Kind::SNAPSHOT : Kind::EVENTS, userData));
+
+        subscriber->eventsListener_ = listener;
+
+        return subscriber;
+    }
+
+    static std::unique_ptr<Subscriber> records(dsp_records_listener_t listener, void *userData) {
+        auto subscriber = std::unique_ptr<Subscriber>(new Subscriber(Kind::RECORDS, userData));
+
+        subscriber->recordsListener_ = listener;
+
+        return subscriber;
+    }
+
+    static std::unique_ptr<Subscriber> columns(dsp_columns_listener_t listener, void *userData) {
+        auto subscriber = std::unique_ptr<Subscriber>(new Subscriber(Kind::COLUMNS, userData));
+
+        subscriber->columnsListener_ = listener;
+
+        return subscriber;
+    }
+
+    static std::unique_ptr<Subscriber> queue(std::shared_ptr<EventQueue> queue) {
+        // The queue is the identity of the subscriber.
+        auto subscriber = std::unique_ptr<Subscriber>(new Subscriber(Kind::QUEUE, queue.get()));
+
+        subscriber->queue_ = std::move(queue);
+
+        return subscriber;
+    }
+
+    Kind getKind() const noexcept {
+        return kind_;
+    }
+
+    /**
+     * @param other The other subscriber
+     * @return `true` if both subscribers have the same format, callback and user data, i.e. they are the same consumer.
+     */
+    bool isSameAs(const Subscriber &other) const noexcept {
+        return kind_ == other.kind_ && eventsListener_ == other.eventsListener_ &&
+               recordsListener_ == other.recordsListener_ && columnsListener_ == other.columnsListener_ &&
+               userData_ == other.userData_;
+    }
+
+    /**
+     * Delivers the records of the batch addressed to the subscriber to its callback.
+     *
+     * @param records The records of the batch
+     * @param size The number of records in the batch
+     * @param indices The ascending indices of the records addressed to the subscriber
+     */
+    void deliver(const dsp_event_record_t *records, std::size_t size, const std::vector<std::uint32_t> &indices) {
+        if (indices.empty()) {
+            return;
+        }
+
+        std::lock_guard lock{mutex_};
+
+        switch (kind_) {
+        case Kind::EVENTS:
+            deliverEvents(records, indices);
+            break;
+        case Kind::RECORDS:
+            deliverRecords(records, size, indices);
+            break;
+        case Kind::COLUMNS:
+            deliverColumns(records, indices);
+            break;
+        case Kind::QUEUE:
+            // The lock also makes the dispatching threads a single producer of the queue.
+            queue_->offer(records, indices);
+            break;
+        case Kind::SNAPSHOT:
+            break;
+        }
+    }
+};
+
+} // namespace dsp
@@ -0,0 +1,226 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace dsp {
+
+/**
+ * Collects the symbols to be added to and removed from the underlying subscriptions and applies them in bulk.
+ *
+ * The changes are made to numbered channels (e.g. one per subscription) and are accumulated for a short window. Then
+ * a background thread applies them with one call per channel for all the added symbols and one call for all the
+ * removed ones. Opposite changes of the same symbol of a channel within the window cancel each other, so a symbol that
+ * is added and removed again never reaches the subscription.
+ *
+ * The window may be used to batch other work too: the `onWindow` function is called by the background thread before it
+ * applies the changes of every window, and a window may be started without symbol changes (SymbolDiffCoalescer::
+ * schedule()).
+ */
+class SymbolDiffCoalescer final {
+  public:
+    /// Applies the coalesced changes of a channel: `void(std::size_t channel, const std::vector<std::string> &added,
+    /// const std::vector<std::string> &removed)`
+    using Applier =
+        std::function<void(std::size_t, const std::vector<std::string> &, const std::vector<std::string> &)>;
+
+    static constexpr std::chrono::milliseconds DEFAULT_WINDOW{10};
+
+  private:
+    Applier applier_;
+    std::chrono::milliseconds window_;
+    std::function<void()> onThreadStart_;
+    std::function<void()> onWindow_;
+
+    std::mutex mutex_{};
+    std::condition_variable changed_{};
+    using Changes = std::vector<std::unordered_map<std::string, bool>>;
+
+    // channel -> symbol -> `true` if the symbol must be added, `false` if it must be removed
+    Changes pending_;
+    std::size_t pendingCount_{};
+    bool scheduled_{};
+    bool stopped_{};
+    std::thread thread_{};
+
+    Changes takePending() {
+        pendingCount_ = 0;
+        scheduled_ = false;
+
+        return std::exchange(pending_, Changes(pending_.size()));
+    }
+
+    void change(std::size_t channel, std::string symbol, bool add) {
+        std::unique_lock lock{mutex_};
+        auto &pending = pending_.at(channel);
+
+        if (auto [it, inserted] = pending.try_emplace(std::move(symbol), add); inserted) {
+            pendingCount_++;
+        } else if (it->second != add) {
+            pending.erase(it);
+            pendingCount_--;
+        }
+
+        if (!stopped_) {
+            changed_.notify_one();
+
+            return;
+        }
+
+        // There is no background thread anymore.
+        auto changes = takePending();
+
+        lock.unlock();
+        apply(std::move(changes));
+    }
+
+    void apply(Changes changes) const {
+        if (onWindow_) {
+            onWindow_();
+        }
+
+        for (std::size_t channel = 0; channel < changes.size(); channel++) {
+            if (changes[channel].empty()) {
+                continue;
+            }
+
+            std::vector<std::string> added{};
+            std::vector<std::string> removed{};
+
+            for (auto &[symbol, add] : changes[channel]) {
+                (add ? added : removed).emplace_back(symbol);
+            }
+
+            applier_(channel, added, removed);
+        }
+    }
+
+    void run() {
+        if (onThreadStart_) {
+            onThreadStart_();
+        }
+
+        std::unique_lock lock{mutex_};
+
+        while (!stopped_) {
+            changed_.wait(lock, [this] {
+                return stopped_ || pendingCount_ != 0 || scheduled_;
+            });
+
+            // Let the rapid changes settle.
+            changed_.wait_for(lock, window_, [this] {
+                return stopped_;
+            });
+
+            auto changes = takePending();
+
+            lock.unlock();
+            apply(std::move(changes));
+            lock.lock();
+        }
+    }
+
+  public:
+    /**
+     * @param channels The number of channels
+     * @param applier The function that applies the changes
+     * @param window The time the changes are accumulated for
+     * @param onThreadStart The function called by the background thread before it applies anything (e.g. the
+     *                      warm-up of the thread)
+     * @param onWindow The function called before the changes of every window are applied (and by the calls that apply
+     *                 them after the stop)
+     */
+    SymbolDiffCoalescer(std::size_t channels, Applier applier, std::chrono::milliseconds window = DEFAULT_WINDOW,
+                        std::function<void()> onThreadStart = {}, std::function<void()> onWindow = {})
+        : applier_{std::move(applier)}, window_{window}, onThreadStart_{std::move(onThreadStart)},
+          onWindow_{std::move(onWindow)}, pending_(channels) {
+        thread_ = std::thread([this] {
+            run();
+        });
+    }
+
+    SymbolDiffCoalescer(const SymbolDiffCoalescer &) = delete;
+    SymbolDiffCoalescer &operator=(const SymbolDiffCoalescer &) = delete;
+
+    ~SymbolDiffCoalescer() {
+        stop();
+    }
+
+    /**
+     * Schedules the symbol to be added.
+     *
+     * @param channel The channel
+     * @param symbol The symbol
+     */
+    void add(std::size_t channel, std::string symbol) {
+        change(channel, std::move(symbol), true);
+    }
+
+    /**
+     * Schedules the symbol to be removed.
+     *
+     * @param channel The channel
+     * @param symbol The symbol
+     */
+    void remove(std::size_t channel, std::string symbol) {
+        change(channel, std::move(symbol), false);
+    }
+
+    /**
+     * Starts a window even if no symbols are changed, so `onWindow` is called at its end (immediately after the stop).
+     */
+    void schedule() {
+        std::unique_lock lock{mutex_};
+
+        if (!stopped_) {
+            scheduled_ = true;
+            changed_.notify_one();
+
+            return;
+        }
+
+        auto changes = takePending();
+
+        lock.unlock();
+        apply(std::move(changes));
+    }
+
+    /**
+     * Stops the background thread and applies the remaining changes in the calling thread. The changes made after the
+     * stop are applied immediately.
+     */
+    void stop() {
+        {
+            std::lock_guard lock{mutex_};
+
+            if (stopped_) {
+                return;
+            }
+
+            stopped_ = true;
+            changed_.notify_one();
+        }
+
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+
+        std::unique_lock lock{mutex_};
+        auto changes = takePending();
+
+        lock.unlock();
+        apply(std::move(changes));
+    }
+};
+
+} // namespace dsp
@@ -0,0 +1,107 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include "SymbolTable.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dsp {
+
+/**
+ * The prebuilt list of symbols: the symbols are interned once and kept as the sorted unique ids.
+ *
+ * Applying a list does not touch the strings, so a large universe is cheap to apply again or to several subscribers,
+ * and two lists are compared by a merge of their ids (SymbolList::diff()).
+ */
+class SymbolList final {
+    std::vector<std::uint32_t> ids_{};
+
+  public:
+    SymbolList() = default;
+
+    /**
+     * Interns the symbols. The `nullptr` symbols and the symbols that don't fit into the table are skipped.
+     *
+     * @param symbols The symbol table
+     * @param names The symbols
+     * @param count The number of symbols
+     * @return The list.
+     */
+    static SymbolList intern(SymbolTable &symbols, const char *const *names, std::size_t count) {
+        SymbolList list{};
+
+        list.ids_.reserve(count);
+
+        for (std::size_t i = 0; i < count; i++) {
+            if (names[i] == nullptr) {
+                continue;
+            }
+
+            if (auto id = symbols.intern(names[i]); id != SymbolTable::INVALID_ID) {
+                list.ids_.push_back(id);
+            }
+        }
+
+        std::sort(list.ids_.begin(), list.ids_.end());
+        list.ids_.erase(std::unique(list.ids_.begin(), list.ids_.end()), list.ids_.end());
+
+        return list;
+    }
+
+    /**
+     * @return The sorted unique ids of the symbols.
+     */
+    const std::vector<std::uint32_t> &getIds() const noexcept {
+        return ids_;
+    }
+
+    /**
+     * @return The number of symbols.
+     */
+    std::size_t size() const noexcept {
+        return ids_.size();
+    }
+
+    /**
+     * Compares two sorted unique id sequences in one pass.
+     *
+     * @param from The current ids
+     * @param to The new ids
+     * @param onRemoved The function called for the ids that are only in `from`: `void(std::uint32_t)`
+     * @param onAdded The function called for the ids that are only in `to`: `void(std::uint32_t)`
+     * @param onKept The function called for the ids that are in both: `void(std::uint32_t)`
+     */
+    template <typename OnRemoved, typename OnAdded, typename OnKept>
+    static void diff(const std::vector<std::uint32_t> &from, const std::vector<std::uint32_t> &to,
+                     OnRemoved &&onRemoved, OnAdded &&onAdded, OnKept &&onKept) {
+        std::size_t i = 0;
+        std::size_t j = 0;
+
+        while (i < from.size() && j < to.size()) {
+            if (from[i] < to[j]) {
+                onRemoved(from[i++]);
+            } else if (to[j] < from[i]) {
+                onAdded(to[j++]);
+            } else {
+                onKept(to[j]);
+                i++;
+                j++;
+            }
+        }
+
+        for (; i < from.size(); i++) {
+            onRemoved(from[i]);
+        }
+
+        for (; j < to.size(); j++) {
+            onAdded(to[j]);
+        }
+    }
+};
+
+} // namespace dsp
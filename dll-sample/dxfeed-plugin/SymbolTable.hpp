@@ -0,0 +1,249 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include "SegmentedArray.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dsp {
+
+/**
+ * The symbol interning table: maps symbols to dense ids (0, 1, 2...) and back.
+ *
+ * Ids are never reused or removed, so consumers can keep per-symbol state in plain arrays indexed by id.
+ *
+ * Readers (SymbolTable::find(), SymbolTable::name()) are lock-free and can be called on the feed thread. Writers
+ * (SymbolTable::intern() of a new symbol) are serialized by a mutex. The names are stored in fixed-size segments that
+ * are never moved (SegmentedArray), and the hash index is an open-addressing table that is rebuilt on growth and
+ * published through an atomic pointer. The replaced indexes are retired until the table is destroyed, because a reader
+ * may still probe them.
+ */
+class SymbolTable final {
+  public:
+    static constexpr std::uint32_t INVALID_ID = static_cast<std::uint32_t>(-1);
+
+  private:
+    static constexpr std::size_t INITIAL_INDEX_CAPACITY = 1024;
+
+    struct Entry {
+        std::string name{};
+        std::size_t hash{};
+    };
+
+    struct Index {
+        std::size_t mask;
+        // id + 1 or 0 if the slot is empty
+        std::unique_ptr<std::atomic<std::uint32_t>[]> slots;
+
+        explicit Index(std::size_t capacity) : mask{capacity - 1}, slots{new std::atomic<std::uint32_t>[capacity]} {
+            for (std::size_t i = 0; i < capacity; i++) {
+                slots[i].store(0, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    SegmentedArray<Entry> entries_{};
+    std::atomic<std::uint32_t> size_{};
+    std::atomic<Index *> index_{};
+
+    std::mutex mutex_{};
+    std::vector<std::unique_ptr<Index>> ownedIndexes_{};
+
+    const Entry &entry(std::uint32_t id) const noexcept {
+        return *entries_.find(id);
+    }
+
+    static void insert(Index &index, std::size_t hash, std::uint32_t id) noexcept {
+        for (auto i = hash & index.mask;; i = (i + 1) & index.mask) {
+            if (index.slots[i].load(std::memory_order_relaxed) == 0) {
+                index.slots[i].store(id + 1, std::memory_order_release);
+
+                return;
+            }
+        }
+    }
+
+    // Must be called under the mutex. Keeps the index at most half full, so probing always reaches an empty slot.
+    Index &reserveIndex(std::size_t size) {
+        auto *index = index_.load(std::memory_order_relaxed);
+
+        if (size * 2 <= index->mask + 1) {
+            return *index;
+        }
+
+        auto newIndex = std::make_unique<Index>((index->mask + 1) * 2);
+
+        for (std::uint32_t id = 0; id < size_.load(std::memory_order_relaxed); id++) {
+            insert(*newIndex, entry(id).hash, id);
+        }
+
+        index_.store(newIndex.get(), std::memory_order_release);
+        ownedIndexes_.emplace_back(std::move(newIndex));
+
+        return *ownedIndexes_.back();
+    }
+
+    std::uint32_t find(std::string_view symbol, std::size_t hash) const noexcept {
+        const auto *index = index_.load(std::memory_order_acquire);
+
+        for (auto i = hash & index->mask;; i = (i + 1) & index->mask) {
+            auto slot = index->slots[i].load(std::memory_order_acquire);
+
+            if (slot == 0) {
+                return INVALID_ID;
+            }
+
+            if (const auto &e = entry(slot - 1); e.hash == hash && e.name == symbol) {
+                return slot - 1;
+            }
+        }
+    }
+
+  public:
+    SymbolTable() {
+        ownedIndexes_.emplace_back(std::make_unique<Index>(INITIAL_INDEX_CAPACITY));
+        index_.store(ownedIndexes_.back().get(), std::memory_order_release);
+    }
+
+    SymbolTable(const SymbolTable &) = delete;
+    SymbolTable &operator=(const SymbolTable &) = delete;
+
+    /**
+     * Returns the id of the symbol (lock-free).
+     *
+     * @param symbol The symbol
+     * @return The id or SymbolTable::INVALID_ID if the symbol was not interned.
+     */
+    std::uint32_t find(std::string_view symbol) const noexcept {
+        return find(symbol, std::hash<std::string_view>{}(symbol));
+    }
+
+    /**
+     * Returns the id of the symbol and interns the symbol if it is new. Lock-free if the symbol is already interned.
+     *
+     * @param symbol The symbol
+     * @return The id or SymbolTable::INVALID_ID if the table is full.
+     */
+    std::uint32_t intern(std::string_view symbol) {
+        auto hash = std::hash<std::string_view>{}(symbol);
+
+        if (auto id = find(symbol, hash); id != INVALID_ID) {
+            return id;
+        }
+
+        std::lock_guard lock{mutex_};
+
+        if (auto id = find(symbol, hash); id != INVALID_ID) {
+            return id;
+        }
+
+        auto id = size_.load(std::memory_order_relaxed);
+
+        auto *newEntry = entries_.findOrAllocate(id);
+
+        if (newEntry == nullptr) {
+            return INVALID_ID;
+        }
+
+        newEntry->name = symbol;
+        newEntry->hash = hash;
+
+        insert(reserveIndex(id + 1), hash, id);
+        size_.store(id + 1, std::memory_order_release);
+
+        return id;
+    }
+
+    /**
+     * Returns the symbol by its id (lock-free). The returned string lives as long as the table.
+     *
+     * @param id The id
+     * @return The symbol or `nullptr` if the id is unknown.
+     */
+    const char *name(std::uint32_t id) const noexcept {
+        if (id >= size_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+
+        return entry(id).name.c_str();
+    }
+
+    /**
+     * @return The number of interned symbols (all the ids are less than this number).
+     */
+    std::uint32_t size() const noexcept {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * The memo of the last interned symbol for the loops that intern the symbols of a batch.
+     *
+     * The events of a batch often come in runs of one symbol (order books, time series, snapshots), so an event of a
+     * run costs one comparison with the interned name instead of a hash and a probe. The memo refers to the name stored
+     * in the table, so it does not copy strings. When the symbols do not repeat, the comparisons are skipped for a
+     * while after several misses in a row. One memo per thread.
+     */
+    class RunCache final {
+        static constexpr std::size_t MAX_MISSES = 8;
+        static constexpr std::size_t BYPASS_LENGTH = 64;
+
+        SymbolTable &table_;
+        std::uint32_t id_ = INVALID_ID;
+        const std::string *name_{};
+        std::size_t misses_{};
+        std::size_t bypass_{};
+
+      public:
+        /**
+         * @param table The table
+         */
+        explicit RunCache(SymbolTable &table) noexcept : table_{table} {
+        }
+
+        /**
+         * Returns the id of the symbol and interns the symbol if it is new (see SymbolTable::intern()).
+         *
+         * @param symbol The symbol
+         * @return The id or SymbolTable::INVALID_ID if the table is full.
+         */
+        std::uint32_t intern(std::string_view symbol) {
+            if (bypass_ != 0) {
+                bypass_--;
+
+                return table_.intern(symbol);
+            }
+
+            if (name_ != nullptr && *name_ == symbol) {
+                misses_ = 0;
+
+                return id_;
+            }
+
+            if (++misses_ == MAX_MISSES) {
+                misses_ = 0;
+                bypass_ = BYPASS_LENGTH;
+            }
+
+            auto id = table_.intern(symbol);
+
+            if (id != INVALID_ID) {
+                id_ = id;
+                name_ = &table_.entry(id).name;
+            }
+
+            return id;
+        }
+    };
+};
+
+} // namespace dsp
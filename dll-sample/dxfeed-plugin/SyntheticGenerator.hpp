@@ -0,0 +1,159 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <plugin-api.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dsp {
+
+/**
+ * The deterministic generator of the quote and trade ticks of a fixed set of symbols: the same configuration (and
+ * seed) gives the same ticks on every platform, so the runs are comparable.
+ *
+ * The symbols of the ticks are drawn uniformly or by the Zipf distribution (a few symbols get most of the ticks, as on
+ * a real feed). Every symbol has a mid price that walks randomly by one cent, the quotes are one cent around it and
+ * the trades are at the bid or the ask.
+ */
+class SyntheticGenerator final {
+  public:
+    /**
+     * The distribution of the symbols of the ticks.
+     */
+    enum class Distribution {
+        UNIFORM,
+        ZIPF,
+    };
+
+    /**
+     * The configuration of the generator.
+     */
+    struct Config {
+        /// The number of symbols.
+        std::size_t symbols = 1000;
+        /// The share of the trades among the ticks.
+        double tradeRatio = 0.2;
+        /// The distribution of the symbols of the ticks.
+        Distribution distribution = Distribution::UNIFORM;
+        /// The seed of the random numbers.
+        std::uint64_t seed = 1;
+        /// The prefix of the symbol names: the symbols are `<prefix>0`, `<prefix>1`, etc.
+        std::string prefix = "SYN";
+    };
+
+    /**
+     * The tick: a quote (the bid and ask fields) or a trade (the price and size fields).
+     */
+    struct Tick {
+        dsp_event_type_t type;
+        std::size_t symbol;
+        double bidPrice;
+        double bidSize;
+        double askPrice;
+        double askSize;
+        double price;
+        double size;
+    };
+
+  private:
+    Config config_;
+    std::uint64_t state_;
+    std::vector<std::string> symbols_{};
+    // In cents.
+    std::vector<std::int64_t> mids_{};
+    // The cumulative distribution of the symbols (Distribution::ZIPF only).
+    std::vector<double> cdf_{};
+
+    // xorshift64*: the same numbers on every platform (unlike the distributions of <random>).
+    std::uint64_t nextRandom() noexcept {
+        state_ ^= state_ >> 12;
+        state_ ^= state_ << 25;
+        state_ ^= state_ >> 27;
+
+        return state_ * 2685821657736338717ULL;
+    }
+
+    // In [0, 1).
+    double nextDouble() noexcept {
+        return static_cast<double>(nextRandom() >> 11) * 0x1.0p-53;
+    }
+
+    std::size_t nextSymbol() noexcept {
+        if (config_.distribution == Distribution::UNIFORM) {
+            return static_cast<std::size_t>(nextRandom() % symbols_.size());
+        }
+
+        auto index = std::upper_bound(cdf_.begin(), cdf_.end(), nextDouble()) - cdf_.begin();
+
+        return std::min(static_cast<std::size_t>(index), symbols_.size() - 1);
+    }
+
+  public:
+    /**
+     * @param config The configuration (at least one symbol)
+     */
+    explicit SyntheticGenerator(Config config)
+        : config_{std::move(config)}, state_{config_.seed == 0 ? 1 : config_.seed} {
+        config_.symbols = std::max<std::size_t>(config_.symbols, 1);
+        symbols_.reserve(config_.symbols);
+        mids_.reserve(config_.symbols);
+
+        for (std::size_t i = 0; i < config_.symbols; i++) {
+            symbols_.push_back(config_.prefix + std::to_string(i));
+            mids_.push_back(1000 + static_cast<std::int64_t>(nextRandom() % 100000));
+        }
+
+        if (config_.distribution == Distribution::ZIPF) {
+            double sum = 0;
+
+            cdf_.reserve(config_.symbols);
+
+            for (std::size_t i = 0; i < config_.symbols; i++) {
+                sum += 1.0 / static_cast<double>(i + 1);
+                cdf_.push_back(sum);
+            }
+
+            for (auto &p : cdf_) {
+                p /= sum;
+            }
+        }
+    }
+
+    /**
+     * @return The symbols (the tick symbols are the indices in this vector).
+     */
+    const std::vector<std::string> &getSymbols() const noexcept {
+        return symbols_;
+    }
+
+    /**
+     * @return The next tick.
+     */
+    Tick next() noexcept {
+        auto symbol = nextSymbol();
+        auto &mid = mids_[symbol];
+        auto random = nextRandom();
+
+        // The mid price walks by one cent, but stays positive.
+        mid = std::max<std::int64_t>(mid + static_cast<std::int64_t>(random % 3) - 1, 2);
+
+        auto bid = static_cast<double>(mid - 1) / 100.0;
+        auto ask = static_cast<double>(mid + 1) / 100.0;
+        auto size = static_cast<double>(1 + (random >> 8) % 100) * 100.0;
+
+        if (nextDouble() < config_.tradeRatio) {
+            return {DSP_ET_TRADE, symbol, 0, 0, 0, 0, (random >> 16) % 2 == 0 ? bid : ask, size};
+        }
+
+        return {DSP_ET_QUOTE, symbol, bid, size, ask, size + 100.0, 0, 0};
+    }
+};
+
+} // namespace dsp
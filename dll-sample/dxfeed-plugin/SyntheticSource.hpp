@@ -0,0 +1,246 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <plugin-api.h>
+
+#include "EventSource.hpp"
+#include "Histogram.hpp"
+#include "Pipeline.hpp"
+#include "SymbolTable.hpp"
+#include "SyntheticGenerator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace dsp {
+
+/**
+ * The deterministic in-process source of the quotes and trades (SyntheticGenerator) for the load tests and the
+ * profiling of the plugin without a network or a JVM.
+ *
+ * The address is `synthetic:` followed by the comma-separated options (the unknown options are ignored):
+ * - `symbols=<n>` - the number of symbols (`SYN0`, `SYN1`, etc.), 1000 by default;
+ * - `rate=<n>` - the events per second, 0 (the default) means as fast as possible;
+ * - `batch=<n>` - the events per delivery, 256 by default;
+ * - `distribution=uniform|zipf` - the distribution of the symbols of the events, uniform by default;
+ * - `trades=<ratio>` - the share of the trades among the events, 0.2 by default;
+ * - `seed=<n>` - the seed, 1 by default;
+ * - `prefix=<prefix>` - the prefix of the symbols, `SYN` by default.
+ *
+ * For example, `synthetic:symbols=10000,rate=1000000,distribution=zipf`. One thread generates the events and delivers
+ * them to the pipeline as the feed would: the quotes and the trades by separate batches. The events of all the symbols
+ * are generated whatever the subscription, the router drops those that nobody is subscribed to. The events have no
+ * event time, so they are not counted in the lag statistics.
+ */
+class SyntheticSource final : public EventSource {
+  public:
+    /// The scheme of the addresses of the source.
+    static constexpr std::string_view SCHEME = "synthetic:";
+
+    /**
+     * The configuration of the source.
+     */
+    struct Config {
+        SyntheticGenerator::Config generator{};
+        std::size_t rate = 0;
+        std::size_t batch = 256;
+    };
+
+  private:
+    Pipeline &pipeline_;
+    SymbolTable &symbols_;
+    std::atomic<bool> running_{};
+    std::atomic<std::uint64_t> delivered_{};
+    std::thread thread_{};
+
+    static void apply(Config &config, std::string_view key, const std::string &value) {
+        if (key == "symbols") {
+            config.generator.symbols = static_cast<std::size_t>(std::strtoull(value.c_str(), nullptr, 10));
+        } else if (key == "rate") {
+            config.rate = static_cast<std::size_t>(std::strtoull(value.c_str(), nullptr, 10));
+        } else if (key == "batch") {
+            config.batch = std::max<std::size_t>(std::strtoull(value.c_str(), nullptr, 10), 1);
+        } else if (key == "distribution") {
+            config.generator.distribution = value == "zipf" ? SyntheticGenerator::Distribution::ZIPF
+                                                            : SyntheticGenerator::Distribution::UNIFORM;
+        } else if (key == "trades") {
+            config.generator.tradeRatio = std::strtod(value.c_str(), nullptr);
+        } else if (key == "seed") {
+            config.generator.seed = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "prefix") {
+            config.generator.prefix = value;
+        }
+    }
+
+    static void marshal(const SyntheticGenerator::Tick &tick, std::uint32_t symbolId, double dayVolume,
+                        dsp_event_record_t &record) noexcept {
+        if (tick.type == DSP_ET_QUOTE) {
+            record.quote = dsp_quote_t{{sizeof(dsp_quote_t), DSP_ET_QUOTE, symbolId, 0},
+                                       tick.bidPrice,
+                                       tick.bidSize,
+                                       tick.askPrice,
+                                       tick.askSize};
+        } else {
+            record.trade =
+                dsp_trade_t{{sizeof(dsp_trade_t), DSP_ET_TRADE, symbolId, 0}, tick.price, tick.size, dayVolume};
+        }
+    }
+
+    void run(Config config) {
+        using Clock = std::chrono::steady_clock;
+
+        SyntheticGenerator generator{config.generator};
+        std::vector<std::uint32_t> symbolIds{};
+        std::vector<double> dayVolumes(generator.getSymbols().size());
+        // The ticks of one delivery by the event type.
+        std::vector<SyntheticGenerator::Tick> quotes{};
+        std::vector<SyntheticGenerator::Tick> trades{};
+
+        for (const auto &symbol : generator.getSymbols()) {
+            symbolIds.push_back(symbols_.intern(symbol));
+        }
+
+        quotes.reserve(config.batch);
+        trades.reserve(config.batch);
+
+        auto deliver = [&](dsp_event_type_t eventType, const std::vector<SyntheticGenerator::Tick> &ticks) {
+            if (ticks.empty()) {
+                return;
+            }
+
+            // The ticks have no event time, so no lags are recorded (see dsp_stats_t::lag).
+            pipeline_.process(eventType, ticks.size(), [&](dsp_event_record_t *records, Histogram & /*lags*/) {
+                for (std::size_t i = 0; i < ticks.size(); i++) {
+                    marshal(ticks[i], symbolIds[ticks[i].symbol], dayVolumes[ticks[i].symbol], records[i]);
+                }
+
+                return ticks.size();
+            });
+        };
+
+        auto start = Clock::now();
+        std::uint64_t generated = 0;
+
+        while (running_.load(std::memory_order_relaxed)) {
+            quotes.clear();
+            trades.clear();
+
+            for (std::size_t i = 0; i < config.batch; i++) {
+                auto tick = generator.next();
+
+                if (tick.type == DSP_ET_QUOTE) {
+                    quotes.push_back(tick);
+                } else {
+                    dayVolumes[tick.symbol] += tick.size;
+                    trades.push_back(tick);
+                }
+            }
+
+            deliver(DSP_ET_QUOTE, quotes);
+            deliver(DSP_ET_TRADE, trades);
+            generated += config.batch;
+            delivered_.store(generated, std::memory_order_relaxed);
+
+            if (config.rate != 0) {
+                auto elapsed =
+                    std::chrono::duration<double>(static_cast<double>(generated) / static_cast<double>(config.rate));
+
+                std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(elapsed));
+            }
+        }
+    }
+
+  public:
+    /**
+     * @param pipeline The pipeline the events are delivered to
+     * @param symbols The symbol table
+     */
+    SyntheticSource(Pipeline &pipeline, SymbolTable &symbols) : pipeline_{pipeline}, symbols_{symbols} {
+    }
+
+    /**
+     * Stops the generation.
+     */
+    ~SyntheticSource() override {
+        running_ = false;
+
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    /**
+     * @param address The address
+     * @return `true` if the address is the address of the synthetic source.
+     */
+    static bool isAddress(std::string_view address) noexcept {
+        return address.substr(0, SCHEME.size()) == SCHEME;
+    }
+
+    /**
+     * Parses the configuration.
+     *
+     * @param address The address (`synthetic:<option>=<value>,...`)
+     * @return The configuration.
+     */
+    static Config parse(std::string_view address) {
+        Config config{};
+
+        if (isAddress(address)) {
+            address.remove_prefix(SCHEME.size());
+        }
+
+        while (!address.empty()) {
+            auto end = std::min(address.find(','), address.size());
+            auto option = address.substr(0, end);
+
+            if (auto equals = option.find('='); equals != std::string_view::npos) {
+                apply(config, option.substr(0, equals), std::string{option.substr(equals + 1)});
+            }
+
+            address.remove_prefix(std::min(end + 1, address.size()));
+        }
+
+        return config;
+    }
+
+    /**
+     * Starts the generation (once).
+     *
+     * @param address The address (`synthetic:<option>=<value>,...`)
+     */
+    void connect(const std::string &address) override {
+        if (running_.exchange(true)) {
+            return;
+        }
+
+        thread_ = std::thread([this, config = parse(address)] {
+            run(config);
+        });
+    }
+
+    /**
+     * Does nothing: the events of all the symbols are generated.
+     */
+    void applySymbols(std::size_t, const std::vector<std::string> &, const std::vector<std::string> &) override {
+    }
+
+    /**
+     * @return The number of the events generated so far.
+     */
+    std::uint64_t getDeliveredCount() const noexcept {
+        return delivered_.load(std::memory_order_relaxed);
+    }
+};
+
+} // namespace dsp
@@ -0,0 +1,74 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dsp {
+
+/**
+ * The layout of the tick files written by TickRecorder and read by TickReplay.
+ *
+ * The file is the Header followed by the blocks, appended one by one. Every block is a BlockHeader followed by its
+ * payload:
+ * - Kind::SYMBOLS: `count` symbols, each a SymbolHeader followed by the zero-terminated name;
+ * - Kind::EVENTS: `count` event records (dsp_quote_t, dsp_trade_t) of their `struct_size` bytes, back to back.
+ *
+ * Every block, symbol and record starts at a multiple of ALIGNMENT, so the records can be used in place (mapped). A
+ * symbol is defined by a SYMBOLS block before its first event. The symbol ids of the file are dense: the symbols are
+ * numbered from 0 in the order of their definitions (not by the ids of the plugin), so the reader can bound them. A
+ * truncated last block (e.g. the recording process died) ends the file. The integers are in the byte order of the
+ * recording machine.
+ */
+struct TickFile final {
+    static constexpr char MAGIC[8] = {'D', 'S', 'P', 'T', 'I', 'C', 'K', 'S'};
+    static constexpr std::uint32_t VERSION = 2;
+    // "BLK1" in the little-endian order.
+    static constexpr std::uint32_t BLOCK_MAGIC = 0x314B4C42;
+    static constexpr std::size_t ALIGNMENT = 8;
+
+    enum class Kind : std::uint32_t {
+        SYMBOLS = 1,
+        EVENTS = 2,
+    };
+
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t reserved;
+        // The wall-clock time the recording started at, in milliseconds since the Unix epoch.
+        std::int64_t startTimeMillis;
+    };
+
+    struct BlockHeader {
+        std::uint32_t magic;
+        Kind kind;
+        // The size of the block including the header.
+        std::uint32_t size;
+        std::uint32_t count;
+        // The time the events were delivered to the plugin, in nanoseconds since the recording started.
+        std::int64_t receivedNs;
+    };
+
+    struct SymbolHeader {
+        std::uint32_t symbolId;
+        // The size of the symbol including the header, the name and the padding.
+        std::uint32_t size;
+    };
+
+    /**
+     * @param size The size
+     * @return The size rounded up to the multiple of ALIGNMENT.
+     */
+    static constexpr std::size_t align(std::size_t size) noexcept {
+        return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+};
+
+static_assert(sizeof(TickFile::Header) == 24);
+static_assert(sizeof(TickFile::BlockHeader) == 24);
+static_assert(sizeof(TickFile::SymbolHeader) == 8);
+
+} // namespace dsp
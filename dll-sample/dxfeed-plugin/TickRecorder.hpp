@@ -0,0 +1,360 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <plugin-api.h>
+
+#include "StopWatch.hpp"
+#include "SymbolTable.hpp"
+#include "TickFile.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dsp {
+
+/**
+ * Records the quotes and trades delivered by the plugin into a tick file (see TickFile) for the deterministic replay
+ * (TickReplay): every batch becomes an events block with the time the batch was delivered to the plugin, preceded by
+ * the definitions of its new symbols. The events are recorded with the symbol ids of the file (see TickFile).
+ *
+ * The recording is started and stopped at any time. While it's stopped, TickRecorder::record() costs one atomic load.
+ * While it's started, the threads that dispatch the batches copy them into a buffer under a mutex (so the copies of
+ * the dispatch threads are serialized), and a writer thread writes the buffer to the file once it's filled, outside
+ * of the mutex. The dispatch threads wait for the writer only if the disk falls MAX_PENDING_SIZE bytes behind.
+ *
+ * The recording stops at the first failed write (e.g. the disk is full): TickRecorder::stop() reports it, and the file
+ * is readable up to the last complete block.
+ */
+class TickRecorder final {
+    // The size of the buffer the writer writes at once.
+    static constexpr std::size_t FILE_BUFFER_SIZE = 1 << 20;
+    // The size of the blocks not written yet the dispatch threads wait for the writer at.
+    static constexpr std::size_t MAX_PENDING_SIZE = 8 * FILE_BUFFER_SIZE;
+
+    const SymbolTable &symbols_;
+    // Serializes start() and stop(), which wait for the writer outside of the mutex of the blocks.
+    std::mutex controlMutex_{};
+    std::mutex mutex_{};
+    std::condition_variable changed_{};
+    std::atomic<bool> recording_{};
+    std::FILE *file_{};
+    // `true` after the first failed write of the current recording.
+    bool failed_{};
+    // `true` while the recording is stopped: the writer writes the remaining blocks and exits.
+    bool stopping_{};
+    std::thread writer_{};
+    std::int64_t startNs_{};
+    // The plugin's symbol id -> the id of the file (SymbolTable::INVALID_ID if not defined yet).
+    std::vector<std::uint32_t> fileIds_{};
+    std::uint32_t fileIdCount_{};
+    // The complete blocks not handed to the writer yet, followed by the block being written.
+    std::vector<char> pending_{};
+    // The offset of the block being written in the pending blocks.
+    std::size_t blockOffset_{};
+    std::uint64_t eventCount_{};
+
+    template <typename T> void append(const T &value) {
+        append(&value, sizeof(T));
+    }
+
+    void append(const void *data, std::size_t size) {
+        auto offset = pending_.size();
+
+        pending_.resize(offset + TickFile::align(size));
+        std::memcpy(pending_.data() + offset, data, size);
+    }
+
+    // Starts a block, its header is completed by finishBlock().
+    void startBlock(TickFile::Kind kind, std::int64_t receivedNs) {
+        blockOffset_ = pending_.size();
+        append(TickFile::BlockHeader{TickFile::BLOCK_MAGIC, kind, 0, 0, receivedNs});
+    }
+
+    void finishBlock(std::uint32_t count) {
+        auto *header = reinterpret_cast<TickFile::BlockHeader *>(pending_.data() + blockOffset_);
+
+        header->size = static_cast<std::uint32_t>(pending_.size() - blockOffset_);
+        header->count = count;
+    }
+
+    // Drops the block being written.
+    void cancelBlock() {
+        pending_.resize(blockOffset_);
+    }
+
+    static bool isRecorded(const dsp_event_record_t &record) noexcept {
+        return record.event.type == DSP_ET_QUOTE || record.event.type == DSP_ET_TRADE;
+    }
+
+    bool isDefined(std::uint32_t symbolId) const noexcept {
+        return symbolId < fileIds_.size() && fileIds_[symbolId] != SymbolTable::INVALID_ID;
+    }
+
+    // Defines the symbols of the records that were not defined yet, with the next ids of the file.
+    void defineSymbols(const dsp_event_record_t *records, std::size_t size, std::int64_t receivedNs) {
+        std::uint32_t count = 0;
+
+        for (std::size_t i = 0; i < size; i++) {
+            auto symbolId = records[i].event.symbol_id;
+
+            if (!isRecorded(records[i]) || isDefined(symbolId)) {
+                continue;
+            }
+
+            if (count == 0) {
+                startBlock(TickFile::Kind::SYMBOLS, receivedNs);
+            }
+
+            if (symbolId >= fileIds_.size()) {
+                fileIds_.resize(std::max<std::size_t>(symbolId + 1, fileIds_.size() * 2), SymbolTable::INVALID_ID);
+            }
+
+            const auto *name = symbols_.name(symbolId);
+            auto length = name == nullptr ? 0 : std::strlen(name);
+
+            fileIds_[symbolId] = fileIdCount_++;
+            append(TickFile::SymbolHeader{
+                fileIds_[symbolId],
+                static_cast<std::uint32_t>(sizeof(TickFile::SymbolHeader) + TickFile::align(length + 1))});
+            append(name == nullptr ? "" : name, length + 1);
+            count++;
+        }
+
+        if (count != 0) {
+            finishBlock(count);
+        }
+    }
+
+    // Stops the recording at the first failed write. Called under the mutex.
+    void fail() {
+        failed_ = true;
+        recording_ = false;
+        pending_.clear();
+        changed_.notify_all();
+    }
+
+    // The writer thread: writes the pending blocks once they fill the buffer and, when the recording is stopped, the
+    // remaining ones.
+    void runWriter() {
+        std::vector<char> buffer{};
+        std::unique_lock lock{mutex_};
+
+        while (!failed_) {
+            changed_.wait(lock, [this] {
+                return stopping_ || failed_ || pending_.size() >= FILE_BUFFER_SIZE;
+            });
+
+            if (failed_) {
+                return;
+            }
+
+            auto stopping = stopping_;
+
+            // The empty buffer (with its capacity) takes the place of the pending blocks.
+            buffer.swap(pending_);
+            changed_.notify_all();
+            lock.unlock();
+
+            auto written = buffer.empty() || std::fwrite(buffer.data(), 1, buffer.size(), file_) == buffer.size();
+
+            buffer.clear();
+            lock.lock();
+
+            if (!written) {
+                fail();
+            }
+
+            if (stopping) {
+                return;
+            }
+        }
+    }
+
+    // Stops the writer (it writes the remaining blocks) and closes the file. Called under the control mutex.
+    void close() {
+        std::unique_lock lock{mutex_};
+
+        recording_ = false;
+
+        if (writer_.joinable()) {
+            stopping_ = true;
+            changed_.notify_all();
+            lock.unlock();
+            writer_.join();
+            lock.lock();
+        }
+
+        if (file_ != nullptr) {
+            if (std::fclose(file_) != 0) {
+                failed_ = true;
+            }
+
+            file_ = nullptr;
+        }
+
+        stopping_ = false;
+        pending_.clear();
+    }
+
+  public:
+    /**
+     * @param symbols The symbol table the names of the recorded symbols are taken from
+     */
+    explicit TickRecorder(const SymbolTable &symbols) : symbols_{symbols} {
+    }
+
+    TickRecorder(const TickRecorder &) = delete;
+    TickRecorder &operator=(const TickRecorder &) = delete;
+
+    /**
+     * Stops the recording.
+     */
+    ~TickRecorder() {
+        stop();
+    }
+
+    /**
+     * Starts the recording into the file (truncated). Stops the current recording.
+     *
+     * @param fileName The name of the file
+     * @return `true` if the file was created.
+     */
+    bool start(const std::string &fileName) {
+        std::lock_guard controlLock{controlMutex_};
+
+        close();
+
+        std::lock_guard lock{mutex_};
+
+        file_ = std::fopen(fileName.c_str(), "wb");
+
+        if (file_ == nullptr) {
+            return false;
+        }
+
+        TickFile::Header header{{}, TickFile::VERSION, 0,
+                                std::chrono::duration_cast<std::chrono::milliseconds>(
+                                    std::chrono::system_clock::now().time_since_epoch())
+                                    .count()};
+
+        std::memcpy(header.magic, TickFile::MAGIC, sizeof(header.magic));
+
+        if (std::fwrite(&header, sizeof(header), 1, file_) != 1) {
+            std::fclose(file_);
+            file_ = nullptr;
+
+            return false;
+        }
+
+        startNs_ = StopWatch::now();
+        fileIds_.clear();
+        fileIdCount_ = 0;
+        eventCount_ = 0;
+        failed_ = false;
+        writer_ = std::thread([this] {
+            runWriter();
+        });
+        recording_ = true;
+
+        return true;
+    }
+
+    /**
+     * Stops the recording and closes the file.
+     *
+     * @return `false` if a write of the last recording failed (the recording was stopped at the first failure).
+     */
+    bool stop() {
+        std::lock_guard controlLock{controlMutex_};
+
+        close();
+
+        std::lock_guard lock{mutex_};
+
+        return !failed_;
+    }
+
+    /**
+     * @return `true` if the recording is started (and no write has failed).
+     */
+    bool isRecording() const noexcept {
+        return recording_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Records the quotes and trades of the batch (the other events are skipped) if the recording is started.
+     *
+     * @param receivedNs The time the batch was delivered to the plugin (StopWatch::now())
+     * @param records The records
+     * @param size The number of records
+     */
+    void record(std::int64_t receivedNs, const dsp_event_record_t *records, std::size_t size) {
+        if (!recording_.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        std::unique_lock lock{mutex_};
+
+        // The back pressure of a slow disk.
+        changed_.wait(lock, [this] {
+            return pending_.size() < MAX_PENDING_SIZE || failed_ || stopping_;
+        });
+
+        if (file_ == nullptr || failed_ || stopping_) {
+            return;
+        }
+
+        // The batches delivered before the start.
+        receivedNs = std::max<std::int64_t>(receivedNs - startNs_, 0);
+        defineSymbols(records, size, receivedNs);
+        startBlock(TickFile::Kind::EVENTS, receivedNs);
+
+        std::uint32_t count = 0;
+
+        for (std::size_t i = 0; i < size; i++) {
+            if (isRecorded(records[i])) {
+                auto record = records[i];
+
+                record.event.symbol_id = fileIds_[record.event.symbol_id];
+                append(&record, std::min<std::size_t>(record.event.struct_size, sizeof(dsp_event_record_t)));
+                count++;
+            }
+        }
+
+        if (count == 0) {
+            cancelBlock();
+
+            return;
+        }
+
+        finishBlock(count);
+        eventCount_ += count;
+
+        if (pending_.size() >= FILE_BUFFER_SIZE) {
+            changed_.notify_all();
+        }
+    }
+
+    /**
+     * @return The number of the events recorded since the start of the recording.
+     */
+    std::uint64_t getEventCount() {
+        std::lock_guard lock{mutex_};
+
+        return eventCount_;
+    }
+};
+
+} // namespace dsp
@@ -0,0 +1,277 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <plugin-api.h>
+
+#include "MappedFile.hpp"
+#include "TickFile.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dsp {
+
+/**
+ * Replays a tick file written by TickRecorder into a listener: the batches are delivered as they were recorded, at the
+ * recorded pace, faster or as fast as possible.
+ *
+ * The file is mapped, and the events passed to the listener point into the mapping: nothing is copied but the pointers
+ * to the events of a batch. The events are valid during the call of the listener. The mapping is copy-on-write (see
+ * MappedFile), so a listener may modify them: the changes are never written to the file, but the next replays see
+ * them, and skip the rest of a batch at an event that is not valid anymore. The symbol ids of the events are the ids
+ * of the recording: their names are TickReplay::getSymbolName(), not dsp_symbol_name().
+ *
+ * The file is checked when it's opened: the replay stops at the first truncated block, and a file with a damaged block
+ * (e.g. a symbol id out of order, an event of an unknown type, shorter than the struct of its type or of an undefined
+ * symbol) is not opened, so nothing read from the file is trusted for an allocation size, an index or the size of an
+ * event read by the listener.
+ */
+class TickReplay final {
+    std::unique_ptr<MappedFile> file_;
+    const TickFile::Header *header_{};
+    // The events blocks in the order of the file.
+    std::vector<TickFile::BlockHeader *> blocks_{};
+    // The names in the mapping by the symbol id, nullptr if not defined.
+    std::vector<const char *> names_{};
+    std::size_t maxBatchSize_{};
+    std::uint64_t eventCount_{};
+
+    explicit TickReplay(std::unique_ptr<MappedFile> file) : file_{std::move(file)} {
+    }
+
+    // Returns false if the symbols are damaged. The ids must be dense, so the names grow by one per symbol read.
+    bool readSymbols(const std::byte *payload, std::size_t size, std::size_t count) {
+        for (std::size_t i = 0; i < count; i++) {
+            if (size < sizeof(TickFile::SymbolHeader)) {
+                return false;
+            }
+
+            auto *symbol = reinterpret_cast<const TickFile::SymbolHeader *>(payload);
+            auto *name = reinterpret_cast<const char *>(payload + sizeof(TickFile::SymbolHeader));
+
+            if (symbol->size < sizeof(TickFile::SymbolHeader) || symbol->size > size ||
+                symbol->size % TickFile::ALIGNMENT != 0 || symbol->symbolId != names_.size() ||
+                std::memchr(name, '\0', symbol->size - sizeof(TickFile::SymbolHeader)) == nullptr) {
+                return false;
+            }
+
+            names_.push_back(name);
+            payload += symbol->size;
+            size -= symbol->size;
+        }
+
+        return true;
+    }
+
+    // Returns the size of the event at the start of the `size` bytes of the payload (aligned) or 0 if the event is
+    // damaged: only the quotes and trades are recorded, with at least the fields of their structs and of the defined
+    // symbols.
+    std::size_t checkEvent(const std::byte *payload, std::size_t size) const noexcept {
+        if (size < sizeof(dsp_event_t)) {
+            return 0;
+        }
+
+        const auto *event = reinterpret_cast<const dsp_event_t *>(payload);
+        std::uint32_t type{};
+        std::size_t minSize{};
+
+        // The type is read as an integer: the file may hold any value, not only the values of the enum.
+        std::memcpy(&type, payload + offsetof(dsp_event_t, type), sizeof(type));
+
+        if (type == DSP_ET_QUOTE) {
+            minSize = sizeof(dsp_quote_t);
+        } else if (type == DSP_ET_TRADE) {
+            minSize = sizeof(dsp_trade_t);
+        } else {
+            return 0;
+        }
+
+        auto eventSize = TickFile::align(event->struct_size);
+
+        if (event->struct_size < minSize || eventSize > sizeof(dsp_event_record_t) || eventSize > size ||
+            event->symbol_id >= names_.size()) {
+            return 0;
+        }
+
+        return eventSize;
+    }
+
+    // Returns false if the events are damaged (see checkEvent()).
+    bool checkEvents(const std::byte *payload, std::size_t size, std::size_t count) const noexcept {
+        for (std::size_t i = 0; i < count; i++) {
+            auto eventSize = checkEvent(payload, size);
+
+            if (eventSize == 0) {
+                return false;
+            }
+
+            payload += eventSize;
+            size -= eventSize;
+        }
+
+        return true;
+    }
+
+    // Indexes the blocks up to the end of the file or the first truncated block. Returns false if a block is damaged.
+    bool index() {
+        auto *data = file_->getData();
+        auto size = file_->getSize();
+        auto offset = sizeof(TickFile::Header);
+
+        while (size - offset >= sizeof(TickFile::BlockHeader)) {
+            auto *block = reinterpret_cast<TickFile::BlockHeader *>(data + offset);
+
+            if (block->magic != TickFile::BLOCK_MAGIC || block->size < sizeof(TickFile::BlockHeader) ||
+                block->size % TickFile::ALIGNMENT != 0) {
+                return false;
+            }
+
+            // The last block was not written completely.
+            if (block->size > size - offset) {
+                break;
+            }
+
+            auto *payload = data + offset + sizeof(TickFile::BlockHeader);
+            auto payloadSize = block->size - sizeof(TickFile::BlockHeader);
+
+            if (block->kind == TickFile::Kind::SYMBOLS) {
+                if (!readSymbols(payload, payloadSize, block->count)) {
+                    return false;
+                }
+            } else if (block->kind == TickFile::Kind::EVENTS) {
+                if (!checkEvents(payload, payloadSize, block->count)) {
+                    return false;
+                }
+
+                blocks_.push_back(block);
+                maxBatchSize_ = std::max<std::size_t>(maxBatchSize_, block->count);
+                eventCount_ += block->count;
+            }
+
+            offset += block->size;
+        }
+
+        return true;
+    }
+
+  public:
+    /**
+     * Opens and indexes the tick file.
+     *
+     * @param fileName The name of the file
+     * @return The replay or `nullptr` if the file can't be mapped, is not a tick file or is damaged.
+     */
+    static std::unique_ptr<TickReplay> open(const std::string &fileName) {
+        auto file = MappedFile::open(fileName);
+
+        if (file == nullptr || file->getSize() < sizeof(TickFile::Header)) {
+            return nullptr;
+        }
+
+        auto *header = reinterpret_cast<const TickFile::Header *>(file->getData());
+
+        if (std::memcmp(header->magic, TickFile::MAGIC, sizeof(header->magic)) != 0 ||
+            header->version != TickFile::VERSION) {
+            return nullptr;
+        }
+
+        std::unique_ptr<TickReplay> replay{new TickReplay(std::move(file))};
+
+        replay->header_ = header;
+
+        return replay->index() ? std::move(replay) : nullptr;
+    }
+
+    /**
+     * @param symbolId The symbol id of a replayed event
+     * @return The name of the symbol or `nullptr` if the id is unknown.
+     */
+    const char *getSymbolName(std::uint32_t symbolId) const noexcept {
+        return symbolId < names_.size() ? names_[symbolId] : nullptr;
+    }
+
+    /**
+     * @return The number of the events of the file.
+     */
+    std::uint64_t getEventCount() const noexcept {
+        return eventCount_;
+    }
+
+    /**
+     * @return The wall-clock time the recording started at, in milliseconds since the Unix epoch.
+     */
+    std::int64_t getStartTimeMillis() const noexcept {
+        return header_->startTimeMillis;
+    }
+
+    /**
+     * Delivers all the batches of the file to the listener on the calling thread.
+     *
+     * @param speed The speed relative to the recording (1 is the recorded pace, 10 is ten times faster), 0 or less
+     * means as fast as possible
+     * @param listener The listener
+     * @param userData The user data of the listener
+     * @return The number of the delivered events.
+     */
+    std::uint64_t replay(double speed, dsp_events_listener_t listener, void *userData) const {
+        using Clock = std::chrono::steady_clock;
+
+        if (blocks_.empty() || listener == nullptr) {
+            return 0;
+        }
+
+        std::vector<dsp_event_t *> events{};
+        std::uint64_t delivered = 0;
+        auto start = Clock::now();
+        auto firstNs = blocks_.front()->receivedNs;
+
+        events.reserve(maxBatchSize_);
+
+        for (auto *block : blocks_) {
+            auto *payload = reinterpret_cast<std::byte *>(block) + sizeof(TickFile::BlockHeader);
+            auto size = block->size - sizeof(TickFile::BlockHeader);
+
+            events.clear();
+
+            for (std::uint32_t i = 0; i < block->count; i++) {
+                // The events were checked by open(), but the listener of a previous replay may have modified them.
+                auto eventSize = checkEvent(payload, size);
+
+                if (eventSize == 0) {
+                    break;
+                }
+
+                events.push_back(reinterpret_cast<dsp_event_t *>(payload));
+                payload += eventSize;
+                size -= eventSize;
+            }
+
+            if (events.empty()) {
+                continue;
+            }
+
+            if (speed > 0) {
+                auto elapsed = std::chrono::duration<double, std::nano>(
+                    static_cast<double>(block->receivedNs - firstNs) / speed);
+
+                std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(elapsed));
+            }
+
+            listener(events.data(), events.size(), userData);
+            delivered += events.size();
+        }
+
+        return delivered;
+    }
+};
+
+} // namespace dsp
@@ -3,35 +3,560 @@
 
 #include <plugin-api.h>
 
-#include <dxfeed_graal_cpp_api/api.hpp>
+// The plugin built without dxFeed Graal CXX API (DSP_DXFEED=0, the platforms without its prebuilt binaries) has no live
+// feed: only the synthetic source and the replay.
+#if DSP_DXFEED
+#    include <dxfeed_graal_cpp_api/api.hpp>
+#endif
 
+#include "EventArena.hpp"
+#include "EventBatch.hpp"
+#include "EventQueue.hpp"
+#include "EventSource.hpp"
+#include "Pipeline.hpp"
+#include "Router.hpp"
+#include "SnapshotTable.hpp"
+#include "SymbolDiffCoalescer.hpp"
+#include "SymbolList.hpp"
+#include "SymbolTable.hpp"
+#include "SyntheticSource.hpp"
+#include "TickRecorder.hpp"
+#include "TickReplay.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static_assert(sizeof(dsp_event_record_t) == DSP_EVENT_RECORD_SIZE);
+static_assert(dsp::SymbolTable::INVALID_ID == DSP_SYMBOL_ID_INVALID);
 
+#if DSP_DXFEED
 using namespace dxfcpp;
 
-class Plugin final {
+// Returns the header of the event struct of type E.
+template <typename E>
+static constexpr dsp_event_t eventHeader(dsp_event_type_t type, std::uint32_t symbolId) noexcept {
+    return dsp_event_t{static_cast<std::uint32_t>(sizeof(E)), type, symbolId, 0};
+}
+
+static void marshal(const Quote &q, std::uint32_t symbolId, dsp_event_record_t &record) noexcept {
+    record.quote = dsp_quote_t{eventHeader<dsp_quote_t>(DSP_ET_QUOTE, symbolId), q.getBidPrice(), q.getBidSize(),
+                               q.getAskPrice(), q.getAskSize()};
+}
+
+static void marshal(const Trade &tr, std::uint32_t symbolId, dsp_event_record_t &record) noexcept {
+    record.trade = dsp_trade_t{eventHeader<dsp_trade_t>(DSP_ET_TRADE, symbolId), tr.getPrice(), tr.getSize(),
+                               tr.getDayVolume()};
+}
+
+static void marshal(const TimeAndSale &ts, std::uint32_t symbolId, dsp_event_record_t &record) noexcept {
+    record.time_and_sale = dsp_time_and_sale_t{eventHeader<dsp_time_and_sale_t>(DSP_ET_TIME_AND_SALE, symbolId),
+                                               ts.getTime(),
+                                               ts.getPrice(),
+                                               ts.getSize(),
+                                               ts.getBidPrice(),
+                                               ts.getAskPrice(),
+                                               ts.getEventFlags(),
+                                               ts.getExchangeCode(),
+                                               static_cast<std::uint8_t>(ts.getAggressorSide().getCode()),
+                                               static_cast<std::uint8_t>(ts.getType().getCode())};
+}
+
+static void marshal(const Order &o, std::uint32_t symbolId, dsp_event_record_t &record) noexcept {
+    record.order = dsp_order_t{eventHeader<dsp_order_t>(DSP_ET_ORDER, symbolId),
+                               o.getIndex(),
+                               o.getTime(),
+                               o.getPrice(),
+                               o.getSize(),
+                               o.getExecutedSize(),
+                               o.getEventFlags(),
+                               o.getExchangeCode(),
+                               static_cast<std::uint8_t>(o.getOrderSide().getCode()),
+                               static_cast<std::uint8_t>(o.getAction().getCode())};
+}
+
+static void marshal(const Summary &su, std::uint32_t symbolId, dsp_event_record_t &record) noexcept {
+    record.summary = dsp_summary_t{eventHeader<dsp_summary_t>(DSP_ET_SUMMARY, symbolId),
+                                   su.getDayId(),
+                                   su.getPrevDayId(),
+                                   su.getDayOpenPrice(),
+                                   su.getDayHighPrice(),
+                                   su.getDayLowPrice(),
+                                   su.getDayClosePrice(),
+                                   su.getPrevDayClosePrice()};
+}
+
+static void marshal(const Profile &p, std::uint32_t symbolId, dsp_event_record_t &record) noexcept {
+    record.profile = dsp_profile_t{eventHeader<dsp_profile_t>(DSP_ET_PROFILE, symbolId),
+                                   p.getHaltStartTime(),
+                                   p.getHaltEndTime(),
+                                   p.getHighLimitPrice(),
+                                   p.getLowLimitPrice(),
+                                   p.getShares(),
+                                   static_cast<std::uint8_t>(p.getTradingStatus().getCode()),
+                                   static_cast<std::uint8_t>(p.getShortSaleRestriction().getCode()),
+                                   {}};
+}
+
+static void marshal(const Candle &c, std::uint32_t symbolId, dsp_event_record_t &record) noexcept {
+    record.candle = dsp_candle_t{eventHeader<dsp_candle_t>(DSP_ET_CANDLE, symbolId),
+                                 c.getTime(),
+                                 c.getOpen(),
+                                 c.getHigh(),
+                                 c.getLow(),
+                                 c.getClose(),
+                                 c.getVolume()};
+}
+
+static const std::string &symbolOf(const MarketEvent &e) noexcept {
+    return e.getEventSymbol();
+}
+
+static const std::string &symbolOf(const Candle &c) noexcept {
+    return c.getEventSymbol().toString();
+}
+
+// Returns the time of the event in milliseconds: the event time or, if there is none, the time of the quote, trade,
+// etc. Returns 0 if the event has no time.
+template <typename E> static std::int64_t timeOf(const E &event) noexcept {
+    if (auto time = event.getEventTime(); time != 0) {
+        return time;
+    }
+
+    if constexpr (requires { event.getTime(); }) {
+        return event.getTime();
+    } else {
+        return 0;
+    }
+}
+
+static std::int64_t currentTimeMillis() noexcept {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+// Converts the events of the batch of the subscription to E to the contiguous array of records and records the lag of
+// every event behind the current time. Returns the number of records written.
+template <typename E>
+static std::size_t marshal(const std::vector<std::shared_ptr<EventType>> &events, dsp::SymbolTable &symbols,
+                           dsp_event_record_t *records, dsp::Histogram &lags) {
+    static constexpr std::uint64_t NANOS_PER_MILLI = 1'000'000;
+
+    // The runs of events of one symbol are interned by a comparison.
+    dsp::SymbolTable::RunCache symbolIds{symbols};
+    auto now = currentTimeMillis();
+    std::size_t size = 0;
+
+    for (const auto &e : events) {
+        // The subscription delivers only the events of type E (or its subclasses).
+        const auto &event = static_cast<const E &>(*e);
+
+        marshal(event, symbolIds.intern(symbolOf(event)), records[size++]);
+
+        // The clocks of the source and of the host may disagree a bit, the negative lags are recorded as 0.
+        if (auto time = timeOf(event); time > 0) {
+            auto lag = static_cast<std::uint64_t>(std::max<std::int64_t>(now - time, 0));
+
+            lags.recordSingleWriter(lag * NANOS_PER_MILLI);
+        }
+    }
+
+    return size;
+}
+#endif
+
+// Attaches the calling thread to the isolate of the SDK: any SDK call does that, the attachment lasts as long as the
+// thread.
+static void attachCurrentThread() {
+#if DSP_DXFEED
+    try {
+        System::getProperty("dxfeed.address");
+    } catch (const RuntimeException &e) {
+        std::cerr << e << '\n';
+    }
+#endif
+}
+
+// The list created by dsp_create_symbol_list().
+struct dsp_symbol_list_t {
+    dsp::SymbolList list;
+};
+
+// The handle of the queue opened by dsp_open_queue().
+struct dsp_queue_t {
+    std::shared_ptr<dsp::EventQueue> queue;
+    dsp::Subscriber *subscriber;
+};
+
+// The handle of the recording opened by dsp_open_replay().
+struct dsp_replay_t {
+    std::unique_ptr<dsp::TickReplay> replay;
+};
+
+#if DSP_DXFEED
+// The live feed: one subscription per event type of the endpoint of the SDK.
+class DxFeedSource final : public dsp::EventSource {
+    // The subscription to one event type.
+    struct Channel {
+        std::shared_ptr<DXFeedSubscription> subscription{};
+    };
+
+    dsp::Pipeline &pipeline;
+    dsp::SymbolTable &symbols;
     std::shared_ptr<DXEndpoint> endpoint;
-    std::shared_ptr<DXFeedSubscription> subscription;
+    // dsp_event_type_t -> channel
+    std::array<Channel, DSP_ET_COUNT> channels;
 
-    Plugin() noexcept {
+    // The events are only valid during the call, so they are marshaled on the feed thread.
+    template <typename E>
+    void onEvents(dsp_event_type_t eventType, const std::vector<std::shared_ptr<EventType>> &events) {
+        if (events.empty()) {
+            return;
+        }
+
+        pipeline.process(eventType, events.size(), [&](dsp_event_record_t *records, dsp::Histogram &lags) {
+            return marshal<E>(events, symbols, records, lags);
+        });
+    }
+
+    // The subscription has no symbols until a consumer asks for the event type, so an unused type costs nothing.
+    template <typename E> void createChannel(dsp_event_type_t eventType) {
+        auto &channel = channels[eventType];
+
+        channel.subscription = endpoint->getFeed()->createSubscription(E::TYPE);
+        channel.subscription->addEventListener([this, eventType](const auto &events) {
+            onEvents<E>(eventType, events);
+        });
+    }
+
+public:
+    DxFeedSource(dsp::Pipeline &pipeline, dsp::SymbolTable &symbols) noexcept : pipeline{pipeline}, symbols{symbols} {
         try {
             endpoint = DXEndpoint::create();
-            subscription = endpoint->getFeed()->createSubscription(
-                {Quote::TYPE, Trade::TYPE});
+            createChannel<Quote>(DSP_ET_QUOTE);
+            createChannel<Trade>(DSP_ET_TRADE);
+            createChannel<TimeAndSale>(DSP_ET_TIME_AND_SALE);
+            createChannel<Order>(DSP_ET_ORDER);
+            createChannel<Summary>(DSP_ET_SUMMARY);
+            createChannel<Profile>(DSP_ET_PROFILE);
+            createChannel<Candle>(DSP_ET_CANDLE);
+        } catch (const RuntimeException &e) {
+            std::cerr << e << '\n';
+        }
+    }
+
+    void connect(const std::string &address) override {
+        if (endpoint) {
+            endpoint->connect(address);
+        }
+    }
+
+    void applySymbols(std::size_t eventType, const std::vector<std::string> &added,
+                      const std::vector<std::string> &removed) override {
+        const auto &channel = channels[eventType];
+
+        if (!channel.subscription) {
+            return;
+        }
+
+        try {
+            if (!removed.empty()) {
+                channel.subscription->removeSymbols(removed);
+            }
+
+            if (!added.empty()) {
+                channel.subscription->addSymbols(added);
+            }
         } catch (const RuntimeException &e) {
             std::cerr << e << '\n';
         }
     }
+};
+#endif
+
+class Plugin final {
+    dsp::SymbolTable symbols;
+    dsp::Router router;
+    dsp::SnapshotTable snapshots;
+    // Records the dispatched batches (dsp_start_recording()). Destroyed after the pipeline.
+    dsp::TickRecorder recorder{symbols};
+    // Marshals and dispatches the batches. Destroyed after the sources, so the queued batches are dispatched while
+    // everything else is alive.
+    dsp::Pipeline pipeline{router, snapshots, &recorder};
+    // The live feed or the synthetic source, created by the first dsp_connect(), so the synthetic runs never create
+    // the endpoint of the SDK. Guarded by the mutex, which the coalescer thread takes to apply the symbols.
+    std::mutex sourceMutex;
+    std::unique_ptr<dsp::EventSource> source;
+    // `true` after dsp_connect(): the dispatch threads can't be changed anymore. Guarded by the source mutex.
+    bool connected = false;
+    // Batches the symbol changes of all the subscribers into bulk subscription calls, one coalescer channel per event
+    // type. Destroyed first: the pending changes are applied while the source is alive.
+    std::unique_ptr<dsp::SymbolDiffCoalescer> coalescer;
+
+    Plugin() noexcept {
+        // The coalescer thread calls the SDK, so it is attached before the first symbol changes.
+        coalescer = std::make_unique<dsp::SymbolDiffCoalescer>(
+            DSP_ET_COUNT,
+            [this](std::size_t eventType, const auto &added, const auto &removed) {
+                std::lock_guard lock{sourceMutex};
+
+                // The symbols changed before the source is created are applied when it is (Plugin::connect()).
+                if (source) {
+                    source->applySymbols(eventType, added, removed);
+                }
+            },
+            dsp::SymbolDiffCoalescer::DEFAULT_WINDOW,
+            attachCurrentThread,
+            [this] {
+                // The routes of the single subscriptions are published before the symbols reach the feed.
+                router.flush();
+            });
+    }
+
+    // Creates the source of the address and subscribes it to the routed symbols. Called under the locks of the routes
+    // and of the source.
+    std::unique_ptr<dsp::EventSource> createSource(const char *address) {
+        std::unique_ptr<dsp::EventSource> created{};
+
+        if (dsp::SyntheticSource::isAddress(address)) {
+            created = std::make_unique<dsp::SyntheticSource>(pipeline, symbols);
+        } else {
+#if DSP_DXFEED
+            created = std::make_unique<DxFeedSource>(pipeline, symbols);
+#else
+            throw std::invalid_argument("The plugin is built without the live feed, only the synthetic source is "
+                                        "available");
+#endif
+        }
+
+        // dsp_event_type_t -> the symbols
+        std::array<std::vector<std::string>, DSP_ET_COUNT> subscribed{};
+
+        router.forEachSymbol([&](std::uint32_t symbolId, dsp_event_type_mask_t eventTypes) {
+            for (std::size_t eventType = 0; eventType < DSP_ET_COUNT; eventType++) {
+                if ((eventTypes & DSP_EVENT_TYPE_MASK(eventType)) != 0) {
+                    subscribed[eventType].emplace_back(symbols.name(symbolId));
+                }
+            }
+        });
+
+        for (std::size_t eventType = 0; eventType < DSP_ET_COUNT; eventType++) {
+            if (!subscribed[eventType].empty()) {
+                created->applySymbols(eventType, subscribed[eventType], {});
+            }
+        }
+
+        return created;
+    }
+
+    void applyChange(std::uint32_t symbolId, dsp::Router::Change change) {
+        if (change.added == 0 && change.removed == 0) {
+            return;
+        }
+
+        const auto *name = symbols.name(symbolId);
+
+        for (std::size_t eventType = 0; eventType < DSP_ET_COUNT; eventType++) {
+            auto mask = DSP_EVENT_TYPE_MASK(eventType);
+
+            if ((change.added & mask) != 0) {
+                coalescer->add(eventType, name);
+            } else if ((change.removed & mask) != 0) {
+                coalescer->remove(eventType, name);
+            }
+        }
+    }
+
+    void addRoute(std::uint32_t symbolId, dsp::Subscriber *subscriber, dsp_event_type_mask_t eventTypes) {
+        applyChange(symbolId, router.addRoute(symbolId, subscriber, eventTypes));
+    }
+
+    void setRoute(std::uint32_t symbolId, dsp::Subscriber *subscriber, dsp_event_type_mask_t eventTypes) {
+        applyChange(symbolId, router.setRoute(symbolId, subscriber, eventTypes));
+    }
+
+    void removeRoute(std::uint32_t symbolId, dsp::Subscriber *subscriber) {
+        applyChange(symbolId, router.removeRoute(symbolId, subscriber));
+    }
 
 public:
-    ~Plugin() noexcept = default;
+    ~Plugin() noexcept {
+        dsp::Pipeline::reportProbes(std::cerr);
+    }
+
+    // Connects the live feed or, if the address starts with "synthetic:", the synthetic source. The first call creates
+    // the source and subscribes it to the symbols subscribed so far, the next ones reconnect it. The dispatch threads
+    // can't be changed after that.
+    void connect(const char *address) {
+        // The routes are locked first (as by the subscriptions), so no symbols are changed while the source is created.
+        auto routesLock = router.lock();
+        std::lock_guard lock{sourceMutex};
+
+        if (!source) {
+            source = createSource(address);
+        }
+
+        connected = true;
+        source->connect(address);
+    }
+
+    // Returns `false` if the endpoint is already connected or there are more threads than the event types.
+    bool setDispatchThreads(std::size_t threads) {
+        std::lock_guard lock{sourceMutex};
+
+        if (connected || threads > dsp::Pipeline::MAX_DISPATCH_THREADS) {
+            return false;
+        }
+
+        pipeline.setDispatchThreads(threads);
+
+        return true;
+    }
+
+    dsp::SymbolTable &getSymbols() noexcept {
+        return symbols;
+    }
+
+    dsp::PipelineStats &getStats() noexcept {
+        return pipeline.getStats();
+    }
+
+    dsp::TickRecorder &getRecorder() noexcept {
+        return recorder;
+    }
+
+    const dsp::SnapshotTable &getSnapshots() const noexcept {
+        return snapshots;
+    }
+
+    // Registers the subscriber for the event types of the symbols. The symbols that are new to the subscriptions are
+    // added to them in bulk. Returns the registered subscriber.
+    dsp::Subscriber *subscribe(const dsp::SymbolList &list, dsp_event_type_mask_t eventTypes,
+                               std::unique_ptr<dsp::Subscriber> subscriber) {
+        dsp::Subscriber *registered = nullptr;
+
+        // The subscriber is found and routed in one update, so a concurrent unsubscription can't remove it in between.
+        router.update([&] {
+            registered = router.addSubscriber(std::move(subscriber));
+
+            for (auto symbolId : list.getIds()) {
+                addRoute(symbolId, registered, eventTypes);
+            }
+        });
+
+        return registered;
+    }
+
+    dsp::Subscriber *subscribe(const char *const *names, std::size_t count, dsp_event_type_mask_t eventTypes,
+                               std::unique_ptr<dsp::Subscriber> subscriber) {
+        return subscribe(createSymbolList(names, count), eventTypes, std::move(subscriber));
+    }
+
+    // Registers the subscriber for the event types of one symbol. The routes of such subscriptions are published once
+    // per coalescing window, so subscribing N symbols one by one rebuilds the routing table once and not N times.
+    void subscribe(const char *name, dsp_event_type_mask_t eventTypes, std::unique_ptr<dsp::Subscriber> subscriber) {
+        auto list = createSymbolList(&name, 1);
+
+        router.defer([&] {
+            auto *registered = router.addSubscriber(std::move(subscriber));
+
+            for (auto symbolId : list.getIds()) {
+                addRoute(symbolId, registered, eventTypes);
+            }
+        });
+        coalescer->schedule();
+    }
+
+    // Unregisters the subscriber of the same consumer as `probe` from the symbols. The symbols that are left without
+    // subscribers are removed from the subscriptions in bulk. The subscriber that is left without symbols is removed
+    // (and destroyed once the batches being dispatched to it are delivered).
+    template <typename SymbolIds> void unsubscribe(const SymbolIds &symbolIds, const dsp::Subscriber &probe) {
+        router.update([&] {
+            auto *registered = router.findSubscriber(probe);
+
+            if (registered == nullptr) {
+                return;
+            }
+
+            for (auto symbolId : symbolIds) {
+                removeRoute(symbolId, registered);
+            }
+
+            router.removeSubscriberIfUnused(registered);
+        });
+    }
+
+    void unsubscribe(const char *const *names, std::size_t count, const dsp::Subscriber &probe) {
+        // The unknown symbols are not interned.
+        std::vector<std::uint32_t> symbolIds{};
+
+        for (std::size_t i = 0; i < count; i++) {
+            if (names[i] == nullptr) {
+                continue;
+            }
+
+            if (auto symbolId = symbols.find(names[i]); symbolId != DSP_SYMBOL_ID_INVALID) {
+                symbolIds.push_back(symbolId);
+            }
+        }
+
+        unsubscribe(symbolIds, probe);
+    }
+
+    // Replaces the symbols of the subscriber: only the difference with the current symbols is applied. The subscriber
+    // whose symbols are replaced with none is removed.
+    void setSymbols(const dsp::SymbolList &list, dsp_event_type_mask_t eventTypes,
+                    std::unique_ptr<dsp::Subscriber> subscriber) {
+        router.update([&] {
+            auto *registered = router.addSubscriber(std::move(subscriber));
+
+            router.setRoutes(registered, list.getIds(), eventTypes, [this](std::uint32_t symbolId, auto change) {
+                applyChange(symbolId, change);
+            });
+            router.removeSubscriberIfUnused(registered);
+        });
+    }
+
+    void setSymbols(const char *const *names, std::size_t count, dsp_event_type_mask_t eventTypes,
+                    std::unique_ptr<dsp::Subscriber> subscriber) {
+        setSymbols(createSymbolList(names, count), eventTypes, std::move(subscriber));
+    }
+
+    dsp::SymbolList createSymbolList(const char *const *names, std::size_t count) {
+        return dsp::SymbolList::intern(symbols, names, count);
+    }
+
+    // Opens the queue and routes the symbols to it.
+    dsp_queue_t *openQueue(const char *const *names, std::size_t count, dsp_event_type_mask_t eventTypes,
+                           std::size_t capacity) {
+        auto queue = std::make_shared<dsp::EventQueue>(capacity);
+        auto *subscriber = subscribe(names, count, eventTypes, dsp::Subscriber::queue(queue));
+
+        return new dsp_queue_t{std::move(queue), subscriber};
+    }
+
+    // Removes all the routes of the queue and destroys it.
+    void closeQueue(dsp_queue_t *queue) {
+        std::unique_ptr<dsp_queue_t> handle{queue};
 
-    std::shared_ptr<DXEndpoint> getEndpoint() const noexcept {
-        return endpoint;
+        router.update([&] {
+            for (auto symbolId : router.getSymbolIds(handle->subscriber)) {
+                removeRoute(symbolId, handle->subscriber);
+            }
+
+            router.removeSubscriber(handle->subscriber);
+        });
     }
 
-    std::shared_ptr<DXFeedSubscription> getSubscription() const noexcept {
-        return subscription;
+    // Applies the pending symbol changes and stops the background thread of the coalescer.
+    void flushSymbols() {
+        coalescer->stop();
     }
 
     static Plugin &getInstance() noexcept {
@@ -41,61 +566,322 @@ public:
     }
 };
 
+// Prints the exception being handled: the functions of the API don't let any exception out to the C caller.
+static void printException() noexcept {
+    try {
+        throw;
+#if DSP_DXFEED
+    } catch (const RuntimeException &e) {
+        std::cerr << e << '\n';
+#endif
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+    } catch (...) {
+        std::cerr << "Unknown exception\n";
+    }
+}
+
 extern "C" {
 
+DLLSAMPLE_API uint32_t dsp_get_api_version() {
+    return DSP_API_VERSION;
+}
+
 DLLSAMPLE_API void dsp_init() {
 
 }
 
 DLLSAMPLE_API void dsp_connect(const char *address) {
+    if (address == nullptr) {
+        return;
+    }
+
     try {
-        Plugin::getInstance().getEndpoint()->connect(address);
-    } catch (const RuntimeException &e) {
-        std::cerr << e << '\n';
+        Plugin::getInstance().connect(address);
+    } catch (...) {
+        printException();
     }
 }
 
+DLLSAMPLE_API int dsp_set_dispatch_threads(uint32_t threads) {
+    try {
+        return Plugin::getInstance().setDispatchThreads(threads) ? 1 : 0;
+    } catch (...) {
+        printException();
+    }
+
+    return 0;
+}
+
 DLLSAMPLE_API void dsp_subscribe(const char *symbol, dsp_events_listener_t events_listener, void *user_data) {
-    Plugin::getInstance().getSubscription()->addEventListener([user_data, events_listener](const auto &events) {
-        auto size = events.size();
+    try {
+        Plugin::getInstance().subscribe(symbol, DSP_EVENT_TYPE_MASK_DEFAULT,
+                                        dsp::Subscriber::events(events_listener, user_data));
+    } catch (...) {
+        printException();
+    }
+}
 
-        if (size == 0) {
-            return;
-        }
+DLLSAMPLE_API void dsp_subscribe_records(const char *symbol, dsp_records_listener_t records_listener,
+                                         void *user_data) {
+    try {
+        Plugin::getInstance().subscribe(symbol, DSP_EVENT_TYPE_MASK_DEFAULT,
+                                        dsp::Subscriber::records(records_listener, user_data));
+    } catch (...) {
+        printException();
+    }
+}
 
-        auto *eventsToListener = new dsp_event_t *[size];
+DLLSAMPLE_API void dsp_subscribe_columns(const char *symbol, dsp_columns_listener_t columns_listener,
+                                         void *user_data) {
+    try {
+        Plugin::getInstance().subscribe(symbol, dsp::Subscriber::COLUMNS_EVENT_TYPES,
+                                        dsp::Subscriber::columns(columns_listener, user_data));
+    } catch (...) {
+        printException();
+    }
+}
 
-        std::size_t index = 0;
+DLLSAMPLE_API int dsp_subscribe_many(const char *const *symbols, size_t count, dsp_event_type_mask_t event_types,
+                                     dsp_events_listener_t events_listener, void *user_data) {
+    if (symbols == nullptr && count != 0) {
+        return 0;
+    }
 
-        for (const auto &e : events) {
-            if (const auto &q = e->template sharedAs<Quote>(); q) {
-                eventsToListener[index++] = dxfcpp::bit_cast<dsp_event_t *>(
-                    new dsp_quote_t{{DSP_ET_QUOTE}, q->getBidPrice(), q->getBidSize(), q->getAskPrice(),
-                                    q->getAskSize()});
-            } else if (const auto &tr = e->template sharedAs<Trade>(); tr) {
-                eventsToListener[index++] = dxfcpp::bit_cast<dsp_event_t *>(
-                    new dsp_trade_t{{DSP_ET_TRADE}, tr->getPrice(), tr->getSize(), tr->getDayVolume()});
-            }
-        };
+    try {
+        Plugin::getInstance().subscribe(symbols, count, event_types,
+                                        dsp::Subscriber::events(events_listener, user_data));
 
-        events_listener(eventsToListener, index, user_data);
+        return 1;
+    } catch (...) {
+        printException();
+    }
 
-        for (std::size_t i = 0; i < index; i++) {
-            if (eventsToListener[i]->type == DSP_ET_QUOTE) {
-                delete dxfcpp::bit_cast<dsp_quote_t *>(eventsToListener[i]);
-            } else if (eventsToListener[i]->type == DSP_ET_TRADE) {
-                delete dxfcpp::bit_cast<dsp_trade_t *>(eventsToListener[i]);
-            }
-        }
+    return 0;
+}
 
-        delete[] eventsToListener;
-    });
+DLLSAMPLE_API void dsp_unsubscribe_many(const char *const *symbols, size_t count, dsp_events_listener_t events_listener,
+                                        void *user_data) {
+    if (symbols == nullptr && count != 0) {
+        return;
+    }
 
-    Plugin::getInstance().getSubscription()->addSymbols(symbol);
+    try {
+        Plugin::getInstance().unsubscribe(symbols, count, *dsp::Subscriber::events(events_listener, user_data));
+    } catch (...) {
+        printException();
+    }
 }
 
-DLLSAMPLE_API void dsp_deinit() {
+DLLSAMPLE_API void dsp_set_symbols(const char *const *symbols, size_t count, dsp_event_type_mask_t event_types,
+                                   dsp_events_listener_t events_listener, void *user_data) {
+    if (symbols == nullptr && count != 0) {
+        return;
+    }
+
+    try {
+        Plugin::getInstance().setSymbols(symbols, count, event_types,
+                                         dsp::Subscriber::events(events_listener, user_data));
+    } catch (...) {
+        printException();
+    }
+}
+
+DLLSAMPLE_API dsp_symbol_list_t *dsp_create_symbol_list(const char *const *symbols, size_t count) {
+    if (symbols == nullptr && count != 0) {
+        return nullptr;
+    }
+
+    try {
+        return new dsp_symbol_list_t{Plugin::getInstance().createSymbolList(symbols, count)};
+    } catch (...) {
+        printException();
+    }
+
+    return nullptr;
+}
+
+DLLSAMPLE_API void dsp_destroy_symbol_list(dsp_symbol_list_t *list) {
+    delete list;
+}
+
+DLLSAMPLE_API void dsp_subscribe_symbol_list(const dsp_symbol_list_t *list, dsp_event_type_mask_t event_types,
+                                             dsp_events_listener_t events_listener, void *user_data) {
+    if (list == nullptr) {
+        return;
+    }
+
+    try {
+        Plugin::getInstance().subscribe(list->list, event_types, dsp::Subscriber::events(events_listener, user_data));
+    } catch (...) {
+        printException();
+    }
+}
+
+DLLSAMPLE_API void dsp_unsubscribe_symbol_list(const dsp_symbol_list_t *list, dsp_events_listener_t events_listener,
+                                               void *user_data) {
+    if (list == nullptr) {
+        return;
+    }
 
+    try {
+        Plugin::getInstance().unsubscribe(list->list.getIds(), *dsp::Subscriber::events(events_listener, user_data));
+    } catch (...) {
+        printException();
+    }
+}
+
+DLLSAMPLE_API void dsp_set_symbol_list(const dsp_symbol_list_t *list, dsp_event_type_mask_t event_types,
+                                       dsp_events_listener_t events_listener, void *user_data) {
+    if (list == nullptr) {
+        return;
+    }
+
+    try {
+        Plugin::getInstance().setSymbols(list->list, event_types, dsp::Subscriber::events(events_listener, user_data));
+    } catch (...) {
+        printException();
+    }
+}
+
+DLLSAMPLE_API dsp_queue_t *dsp_open_queue(const char *const *symbols, size_t count, dsp_event_type_mask_t event_types,
+                                          size_t capacity) {
+    if (symbols == nullptr && count != 0) {
+        return nullptr;
+    }
+
+    try {
+        return Plugin::getInstance().openQueue(symbols, count, event_types, capacity);
+    } catch (...) {
+        printException();
+    }
+
+    return nullptr;
+}
+
+DLLSAMPLE_API size_t dsp_poll(dsp_queue_t *queue, dsp_event_record_t *buffer, size_t max_count) {
+    if (queue == nullptr || buffer == nullptr) {
+        return 0;
+    }
+
+    return queue->queue->poll(buffer, max_count);
+}
+
+DLLSAMPLE_API uint64_t dsp_queue_overflow_count(const dsp_queue_t *queue) {
+    if (queue == nullptr) {
+        return 0;
+    }
+
+    return queue->queue->getOverflowCount();
+}
+
+DLLSAMPLE_API void dsp_close_queue(dsp_queue_t *queue) {
+    if (queue == nullptr) {
+        return;
+    }
+
+    try {
+        Plugin::getInstance().closeQueue(queue);
+    } catch (...) {
+        printException();
+    }
+}
+
+DLLSAMPLE_API int dsp_read_quote(uint32_t symbol_id, dsp_quote_t *quote) {
+    if (quote == nullptr) {
+        return 0;
+    }
+
+    return Plugin::getInstance().getSnapshots().readQuote(symbol_id, *quote) ? 1 : 0;
+}
+
+DLLSAMPLE_API int dsp_read_trade(uint32_t symbol_id, dsp_trade_t *trade) {
+    if (trade == nullptr) {
+        return 0;
+    }
+
+    return Plugin::getInstance().getSnapshots().readTrade(symbol_id, *trade) ? 1 : 0;
+}
+
+DLLSAMPLE_API const char *dsp_symbol_name(uint32_t symbol_id) {
+    return Plugin::getInstance().getSymbols().name(symbol_id);
+}
+
+DLLSAMPLE_API uint32_t dsp_symbol_lookup(const char *symbol) {
+    if (symbol == nullptr) {
+        return DSP_SYMBOL_ID_INVALID;
+    }
+
+    return Plugin::getInstance().getSymbols().find(symbol);
+}
+
+DLLSAMPLE_API int dsp_get_stats(dsp_stats_t *stats) {
+    if (stats == nullptr) {
+        return 0;
+    }
+
+    return Plugin::getInstance().getStats().read(*stats) ? 1 : 0;
+}
+
+DLLSAMPLE_API void dsp_reset_stats() {
+    Plugin::getInstance().getStats().reset();
+}
+
+DLLSAMPLE_API int dsp_start_recording(const char *file_name) {
+    if (file_name == nullptr) {
+        return 0;
+    }
+
+    try {
+        return Plugin::getInstance().getRecorder().start(file_name) ? 1 : 0;
+    } catch (...) {
+        printException();
+    }
+
+    return 0;
+}
+
+DLLSAMPLE_API int dsp_stop_recording() {
+    return Plugin::getInstance().getRecorder().stop() ? 1 : 0;
+}
+
+DLLSAMPLE_API dsp_replay_t *dsp_open_replay(const char *file_name) {
+    if (file_name == nullptr) {
+        return nullptr;
+    }
+
+    try {
+        auto replay = dsp::TickReplay::open(file_name);
+
+        return replay == nullptr ? nullptr : new dsp_replay_t{std::move(replay)};
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+DLLSAMPLE_API const char *dsp_replay_symbol_name(const dsp_replay_t *replay, uint32_t symbol_id) {
+    return replay == nullptr ? nullptr : replay->replay->getSymbolName(symbol_id);
+}
+
+DLLSAMPLE_API uint64_t dsp_replay(const dsp_replay_t *replay, double speed, dsp_events_listener_t events_listener,
+                                  void *user_data) {
+    if (replay == nullptr) {
+        return 0;
+    }
+
+    try {
+        return replay->replay->replay(speed, events_listener, user_data);
+    } catch (...) {
+        return 0;
+    }
+}
+
+DLLSAMPLE_API void dsp_close_replay(dsp_replay_t *replay) {
+    delete replay;
+}
+
+DLLSAMPLE_API void dsp_deinit() {
+    Plugin::getInstance().flushSymbols();
 }
 
 }
\ No newline at end of file
@@ -25,15 +25,49 @@ extern "C" {
 
 #endif
 
+#ifdef __cplusplus
+#    define DSP_STATIC_ASSERT(expression, message) static_assert(expression, message)
+#else
+#    define DSP_STATIC_ASSERT(expression, message) _Static_assert(expression, message)
+#endif
+
+// The version of the plugin ABI described by this header. See dsp_get_api_version().
+#define DSP_API_VERSION 5
+
+// Symbols are interned by the plugin: every symbol gets a dense id (0, 1, 2...) that stays valid until the plugin is
+// unloaded. See dsp_symbol_name() and dsp_symbol_lookup().
+#define DSP_SYMBOL_ID_INVALID UINT32_MAX
+
 typedef enum dsp_event_type_t {
     DSP_ET_QUOTE,
     DSP_ET_TRADE,
+    DSP_ET_TIME_AND_SALE,
+    DSP_ET_ORDER,
+    DSP_ET_SUMMARY,
+    DSP_ET_PROFILE,
+    DSP_ET_CANDLE,
+
+    DSP_ET_COUNT,
 } dsp_event_type_t;
 
-#pragma pack(push, 1)
+// The set of event types a consumer subscribes to: a bitwise OR of DSP_EVENT_TYPE_MASK(DSP_ET_...) values. The plugin
+// subscribes to an event type of a symbol only while some consumer asks for it.
+typedef uint32_t dsp_event_type_mask_t;
 
+#define DSP_EVENT_TYPE_MASK(type) ((dsp_event_type_mask_t)1 << (type))
+#define DSP_EVENT_TYPE_MASK_ALL (DSP_EVENT_TYPE_MASK(DSP_ET_COUNT) - 1)
+// The event types of the single-symbol subscription functions (dsp_subscribe() etc.).
+#define DSP_EVENT_TYPE_MASK_DEFAULT (DSP_EVENT_TYPE_MASK(DSP_ET_QUOTE) | DSP_EVENT_TYPE_MASK(DSP_ET_TRADE))
+
+// The common header of all events.
+// `struct_size` is the size of the whole event struct (dsp_quote_t, dsp_trade_t, etc.) as filled by the plugin. New
+// fields are only ever appended to the end of the event structs, so a consumer built with an older header can read the
+// fields it knows and a consumer built with a newer header must not read the fields beyond `struct_size`.
 typedef struct dsp_event_t {
+    uint32_t struct_size;
     dsp_event_type_t type;
+    uint32_t symbol_id;
+    uint32_t reserved;
 } dsp_event_t;
 
 typedef struct dsp_quote_t {
@@ -53,24 +87,403 @@ typedef struct dsp_trade_t {
     double dayVolume;
 } dsp_trade_t;
 
-#pragma pack(pop)
+// The times are in milliseconds since the Unix epoch. The enumerations (side, action, etc.) are the codes of the
+// corresponding dxFeed enumerations.
+
+typedef struct dsp_time_and_sale_t {
+    dsp_event_t event;
+
+    int64_t time;
+    double price;
+    double size;
+    double bid_price;
+    double ask_price;
+    int32_t event_flags;
+    int16_t exchange_code;
+    uint8_t aggressor_side;
+    uint8_t sale_type;
+} dsp_time_and_sale_t;
+
+typedef struct dsp_order_t {
+    dsp_event_t event;
+
+    int64_t index;
+    int64_t time;
+    double price;
+    double size;
+    double executed_size;
+    int32_t event_flags;
+    int16_t exchange_code;
+    uint8_t side;
+    uint8_t action;
+} dsp_order_t;
+
+typedef struct dsp_summary_t {
+    dsp_event_t event;
+
+    int32_t day_id;
+    int32_t prev_day_id;
+    double day_open_price;
+    double day_high_price;
+    double day_low_price;
+    double day_close_price;
+    double prev_day_close_price;
+} dsp_summary_t;
+
+typedef struct dsp_profile_t {
+    dsp_event_t event;
+
+    int64_t halt_start_time;
+    int64_t halt_end_time;
+    double high_limit_price;
+    double low_limit_price;
+    double shares;
+    uint8_t trading_status;
+    uint8_t short_sale_restriction;
+    uint8_t reserved[6];
+} dsp_profile_t;
+
+typedef struct dsp_candle_t {
+    dsp_event_t event;
+
+    int64_t time;
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume;
+} dsp_candle_t;
+
+#define DSP_EVENT_RECORD_SIZE 64
+
+// A fixed-size tagged event record. `event.type` selects the active member. Records are delivered as one contiguous
+// array with a stride of DSP_EVENT_RECORD_SIZE bytes (one cache line).
+typedef union dsp_event_record_t {
+    dsp_event_t event;
+    dsp_quote_t quote;
+    dsp_trade_t trade;
+    dsp_time_and_sale_t time_and_sale;
+    dsp_order_t order;
+    dsp_summary_t summary;
+    dsp_profile_t profile;
+    dsp_candle_t candle;
+
+    uint8_t padding[DSP_EVENT_RECORD_SIZE];
+} dsp_event_record_t;
+
+// The ABI layout checks: there is no implicit padding and all the fields are naturally aligned.
+DSP_STATIC_ASSERT(sizeof(dsp_event_type_t) == 4, "dsp_event_type_t must be 4 bytes");
+DSP_STATIC_ASSERT(sizeof(dsp_event_t) == 16, "dsp_event_t must be 16 bytes");
+DSP_STATIC_ASSERT(offsetof(dsp_event_t, type) == 4, "dsp_event_t layout mismatch");
+DSP_STATIC_ASSERT(offsetof(dsp_event_t, symbol_id) == 8, "dsp_event_t layout mismatch");
+DSP_STATIC_ASSERT(offsetof(dsp_quote_t, bid_price) == 16, "dsp_quote_t layout mismatch");
+DSP_STATIC_ASSERT(offsetof(dsp_quote_t, ask_size) == 40, "dsp_quote_t layout mismatch");
+DSP_STATIC_ASSERT(sizeof(dsp_quote_t) == 48, "dsp_quote_t must be 48 bytes");
+DSP_STATIC_ASSERT(offsetof(dsp_trade_t, price) == 16, "dsp_trade_t layout mismatch");
+DSP_STATIC_ASSERT(offsetof(dsp_trade_t, dayVolume) == 32, "dsp_trade_t layout mismatch");
+DSP_STATIC_ASSERT(sizeof(dsp_trade_t) == 40, "dsp_trade_t must be 40 bytes");
+DSP_STATIC_ASSERT(offsetof(dsp_time_and_sale_t, event_flags) == 56, "dsp_time_and_sale_t layout mismatch");
+DSP_STATIC_ASSERT(sizeof(dsp_time_and_sale_t) == 64, "dsp_time_and_sale_t must be 64 bytes");
+DSP_STATIC_ASSERT(offsetof(dsp_order_t, event_flags) == 56, "dsp_order_t layout mismatch");
+DSP_STATIC_ASSERT(sizeof(dsp_order_t) == 64, "dsp_order_t must be 64 bytes");
+DSP_STATIC_ASSERT(offsetof(dsp_summary_t, day_open_price) == 24, "dsp_summary_t layout mismatch");
+DSP_STATIC_ASSERT(sizeof(dsp_summary_t) == 64, "dsp_summary_t must be 64 bytes");
+DSP_STATIC_ASSERT(offsetof(dsp_profile_t, trading_status) == 56, "dsp_profile_t layout mismatch");
+DSP_STATIC_ASSERT(sizeof(dsp_profile_t) == 64, "dsp_profile_t must be 64 bytes");
+DSP_STATIC_ASSERT(offsetof(dsp_candle_t, volume) == 56, "dsp_candle_t layout mismatch");
+DSP_STATIC_ASSERT(sizeof(dsp_candle_t) == 64, "dsp_candle_t must be 64 bytes");
+DSP_STATIC_ASSERT(sizeof(dsp_event_record_t) == DSP_EVENT_RECORD_SIZE, "dsp_event_record_t must be one cache line");
+
+// Columnar (struct-of-arrays) view of the quotes of one batch: the i-th quote is {bid_price[i], bid_size[i], ...}.
+// The columns are aligned to the cache line boundary. Only quotes and trades have columnar views.
+typedef struct dsp_quote_columns_t {
+    size_t count;
+
+    const double *bid_price;
+    const double *bid_size;
+    const double *ask_price;
+    const double *ask_size;
+    const uint32_t *symbol_id;
+} dsp_quote_columns_t;
+
+// Columnar (struct-of-arrays) view of the trades of one batch.
+typedef struct dsp_trade_columns_t {
+    size_t count;
+
+    const double *price;
+    const double *size;
+    const double *day_volume;
+    const uint32_t *symbol_id;
+} dsp_trade_columns_t;
 
 typedef void (*dsp_events_listener_t)(dsp_event_t **events, size_t size, void *user_data);
 
+typedef void (*dsp_records_listener_t)(const dsp_event_record_t *records, size_t size, void *user_data);
+
+typedef void (*dsp_columns_listener_t)(const dsp_quote_columns_t *quotes, const dsp_trade_columns_t *trades,
+                                       void *user_data);
+
+typedef uint32_t (*dsp_get_api_version_fn_t)();
+
+// Returns the DSP_API_VERSION the plugin was built with. Consumers should check it before calling other functions.
+DLLSAMPLE_API uint32_t dsp_get_api_version();
+
 typedef void (*dsp_init_fn_t)();
 
 DLLSAMPLE_API void dsp_init();
 
 typedef void (*dsp_connect_fn_t)(const char *);
 
+// Connects to the feed (e.g. "demo.dxfeed.com:7300"). The address "synthetic:<option>=<value>,..." selects the
+// deterministic in-process source of the quotes and trades of the symbols SYN0, SYN1, etc. instead (for the load tests
+// without a network). The options are symbols=<n>, rate=<events per second, 0 - max>, batch=<n>,
+// distribution=uniform|zipf, trades=<ratio>, seed=<n> and prefix=<symbol prefix>. The plugin built without dxFeed
+// Graal CXX API (on the platforms other than Windows) has only the synthetic source.
 DLLSAMPLE_API void dsp_connect(const char *address);
 
+typedef int (*dsp_set_dispatch_threads_fn_t)(uint32_t);
+
+// Sets the number of the persistent threads the listeners are called on. With 0 threads (the default) the listeners are
+// called on the feed thread. Otherwise the feed thread only marshals a batch and hands it over to a thread through a
+// lock-free queue; the batches of every event type are delivered in order by the same thread. Must be called before
+// dsp_connect(). At most DSP_ET_COUNT threads are used, one per event type. Returns 1 on success or 0 on failure (the
+// plugin is already connected, `threads` is greater than DSP_ET_COUNT or the threads can't be started).
+DLLSAMPLE_API int dsp_set_dispatch_threads(uint32_t threads);
+
+// The single-symbol subscription functions below subscribe the listener to the quotes and trades of the symbol. The
+// subscriptions made within the coalescing time (see dsp_subscribe_many()) are routed together: the listener starts
+// receiving the events of the symbol after that time, and subscribing to many symbols one by one rebuilds the routing
+// table once per that time and not once per symbol.
+
 typedef void (*dsp_subscribe_fn_t)(const char *, dsp_events_listener_t, void *);
 
 DLLSAMPLE_API void dsp_subscribe(const char *symbol, dsp_events_listener_t events_listener, void *user_data);
 
+typedef void (*dsp_subscribe_records_fn_t)(const char *, dsp_records_listener_t, void *);
+
+DLLSAMPLE_API void dsp_subscribe_records(const char *symbol, dsp_records_listener_t records_listener, void *user_data);
+
+typedef void (*dsp_subscribe_columns_fn_t)(const char *, dsp_columns_listener_t, void *);
+
+// The columnar view carries only quotes and trades (DSP_EVENT_TYPE_MASK_DEFAULT), the other event types are never
+// delivered to a columns listener.
+DLLSAMPLE_API void dsp_subscribe_columns(const char *symbol, dsp_columns_listener_t columns_listener, void *user_data);
+
+// The bulk subscription functions below identify the consumer by the listener and user data. The symbol changes of all
+// the consumers are coalesced for a short time and then applied to the feed in bulk, so a symbol that is subscribed to
+// and unsubscribed from within this time never reaches the feed. The listener may be NULL: the symbols are then only
+// kept subscribed to fill the snapshot table (see dsp_read_quote()).
+
+typedef int (*dsp_subscribe_many_fn_t)(const char *const *, size_t, dsp_event_type_mask_t, dsp_events_listener_t,
+                                       void *);
+
+// Subscribes the listener to the `event_types` of `count` symbols. The event types of a symbol the listener is already
+// subscribed to are extended. Returns 1 on success or 0 on failure (e.g. `symbols` is NULL or out of memory).
+DLLSAMPLE_API int dsp_subscribe_many(const char *const *symbols, size_t count, dsp_event_type_mask_t event_types,
+                                     dsp_events_listener_t events_listener, void *user_data);
+
+typedef void (*dsp_unsubscribe_many_fn_t)(const char *const *, size_t, dsp_events_listener_t, void *);
+
+// Unsubscribes the listener (subscribed by dsp_subscribe() or dsp_subscribe_many()) from `count` symbols. Does nothing
+// if `symbols` is NULL.
+DLLSAMPLE_API void dsp_unsubscribe_many(const char *const *symbols, size_t count, dsp_events_listener_t events_listener,
+                                        void *user_data);
+
+typedef void (*dsp_set_symbols_fn_t)(const char *const *, size_t, dsp_event_type_mask_t, dsp_events_listener_t,
+                                     void *);
+
+// Replaces the symbols of the listener with the `event_types` of `count` symbols. Only the difference with the current
+// symbols is applied. Does nothing if `symbols` is NULL.
+DLLSAMPLE_API void dsp_set_symbols(const char *const *symbols, size_t count, dsp_event_type_mask_t event_types,
+                                   dsp_events_listener_t events_listener, void *user_data);
+
+// The prebuilt list of symbols: the symbols are resolved once, so a large list is cheap to apply again or to several
+// listeners. A list may be used from any thread and applied any number of times until it is destroyed.
+typedef struct dsp_symbol_list_t dsp_symbol_list_t;
+
+typedef dsp_symbol_list_t *(*dsp_create_symbol_list_fn_t)(const char *const *, size_t);
+
+// Creates the list of `count` symbols (NULL symbols and duplicates are skipped). Returns NULL on failure.
+DLLSAMPLE_API dsp_symbol_list_t *dsp_create_symbol_list(const char *const *symbols, size_t count);
+
+typedef void (*dsp_destroy_symbol_list_fn_t)(dsp_symbol_list_t *);
+
+// Destroys the list. The subscriptions made with the list are kept.
+DLLSAMPLE_API void dsp_destroy_symbol_list(dsp_symbol_list_t *list);
+
+typedef void (*dsp_subscribe_symbol_list_fn_t)(const dsp_symbol_list_t *, dsp_event_type_mask_t, dsp_events_listener_t,
+                                               void *);
+
+// Same as dsp_subscribe_many() with the symbols of the list.
+DLLSAMPLE_API void dsp_subscribe_symbol_list(const dsp_symbol_list_t *list, dsp_event_type_mask_t event_types,
+                                             dsp_events_listener_t events_listener, void *user_data);
+
+typedef void (*dsp_unsubscribe_symbol_list_fn_t)(const dsp_symbol_list_t *, dsp_events_listener_t, void *);
+
+// Same as dsp_unsubscribe_many() with the symbols of the list.
+DLLSAMPLE_API void dsp_unsubscribe_symbol_list(const dsp_symbol_list_t *list, dsp_events_listener_t events_listener,
+                                               void *user_data);
+
+typedef void (*dsp_set_symbol_list_fn_t)(const dsp_symbol_list_t *, dsp_event_type_mask_t, dsp_events_listener_t,
+                                         void *);
+
+// Same as dsp_set_symbols() with the symbols of the list: the difference with the current symbols is found by a merge
+// of the sorted symbol ids, so re-applying an unchanged list changes nothing and costs no string processing.
+DLLSAMPLE_API void dsp_set_symbol_list(const dsp_symbol_list_t *list, dsp_event_type_mask_t event_types,
+                                       dsp_events_listener_t events_listener, void *user_data);
+
+// The queue of the records of the subscribed symbols. The plugin copies the records into the queue on the feed thread,
+// and the consumer polls them from its own thread without locks. Only one thread may poll a queue at a time. The queue
+// is bounded: the records that do not fit are dropped and counted (see dsp_queue_overflow_count()).
+typedef struct dsp_queue_t dsp_queue_t;
+
+typedef dsp_queue_t *(*dsp_open_queue_fn_t)(const char *const *, size_t, dsp_event_type_mask_t, size_t);
+
+// Opens the queue of the records of the `event_types` of `count` symbols. The capacity (in records) is rounded up to a
+// power of two, 0 means the default capacity. Returns NULL on failure (e.g. `symbols` is NULL or the capacity doesn't
+// fit in memory).
+DLLSAMPLE_API dsp_queue_t *dsp_open_queue(const char *const *symbols, size_t count, dsp_event_type_mask_t event_types,
+                                          size_t capacity);
+
+typedef size_t (*dsp_poll_fn_t)(dsp_queue_t *, dsp_event_record_t *, size_t);
+
+// Moves up to `max_count` records from the queue to the buffer. Never blocks. Returns the number of records moved.
+DLLSAMPLE_API size_t dsp_poll(dsp_queue_t *queue, dsp_event_record_t *buffer, size_t max_count);
+
+typedef uint64_t (*dsp_queue_overflow_count_fn_t)(const dsp_queue_t *);
+
+// Returns the total number of records dropped because the queue was full.
+DLLSAMPLE_API uint64_t dsp_queue_overflow_count(const dsp_queue_t *queue);
+
+typedef void (*dsp_close_queue_fn_t)(dsp_queue_t *);
+
+// Unsubscribes the queue and destroys it. The queue must not be polled during and after the call.
+DLLSAMPLE_API void dsp_close_queue(dsp_queue_t *queue);
+
+// The plugin keeps the latest quote and trade of every subscribed symbol. The reads are consistent (never torn), can be
+// made from any thread at any time and never block the feed thread.
+
+typedef int (*dsp_read_quote_fn_t)(uint32_t, dsp_quote_t *);
+
+// Copies the latest quote of the symbol to `quote`. Returns 1 on success or 0 if no quote of the symbol has been
+// received yet.
+DLLSAMPLE_API int dsp_read_quote(uint32_t symbol_id, dsp_quote_t *quote);
+
+typedef int (*dsp_read_trade_fn_t)(uint32_t, dsp_trade_t *);
+
+// Copies the latest trade of the symbol to `trade`. Returns 1 on success or 0 if no trade of the symbol has been
+// received yet.
+DLLSAMPLE_API int dsp_read_trade(uint32_t symbol_id, dsp_trade_t *trade);
+
+typedef const char *(*dsp_symbol_name_fn_t)(uint32_t);
+
+// Returns the symbol by its id or NULL if the id is unknown. The string stays valid until the plugin is unloaded.
+DLLSAMPLE_API const char *dsp_symbol_name(uint32_t symbol_id);
+
+typedef uint32_t (*dsp_symbol_lookup_fn_t)(const char *);
+
+// Returns the id of the symbol or DSP_SYMBOL_ID_INVALID if the symbol has not been subscribed to or received yet.
+DLLSAMPLE_API uint32_t dsp_symbol_lookup(const char *symbol);
+
+// The latency statistics of the plugin. The plugin times every batch of events at three points: when the feed
+// delivers it to the plugin, when it is marshaled to the records and when all the listeners have returned. The
+// statistics are recorded all the time, cheaply enough for production.
+
+// The distribution of one latency in nanoseconds. The percentiles are precise within ~3%, the maximum is exact.
+typedef struct dsp_latency_t {
+    uint64_t count;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+    uint64_t max_ns;
+} dsp_latency_t;
+
+// The caller sets `struct_size` to sizeof(dsp_stats_t) of its header: new fields are only ever appended, and the plugin
+// fills only the fields that fit.
+typedef struct dsp_stats_t {
+    uint32_t struct_size;
+    uint32_t reserved;
+
+    // Per batch: from the delivery to the plugin to the marshaled records.
+    dsp_latency_t marshal;
+    // Per batch: from the marshaled records to the return of the listeners (with the hand-over to a dispatch thread).
+    dsp_latency_t dispatch;
+    // Per batch: from the delivery to the plugin to the return of the listeners.
+    dsp_latency_t total;
+    // Per event: from the event time (the time of the event or, if there is none, of the quote, trade, etc.) to the
+    // delivery to the plugin. The event times are in milliseconds by the clock of the source, the events without a time
+    // are skipped.
+    dsp_latency_t lag;
+} dsp_stats_t;
+
+DSP_STATIC_ASSERT(sizeof(dsp_latency_t) == 40, "dsp_latency_t must be 40 bytes");
+DSP_STATIC_ASSERT(offsetof(dsp_stats_t, marshal) == 8, "dsp_stats_t layout mismatch");
+DSP_STATIC_ASSERT(sizeof(dsp_stats_t) == 168, "dsp_stats_t must be 168 bytes");
+
+typedef int (*dsp_get_stats_fn_t)(dsp_stats_t *);
+
+// Fills the statistics recorded since the plugin was loaded or since dsp_reset_stats(). Returns 1 on success or 0 if
+// `stats` is NULL or its `struct_size` is too small.
+DLLSAMPLE_API int dsp_get_stats(dsp_stats_t *stats);
+
+typedef void (*dsp_reset_stats_fn_t)();
+
+// Forgets the recorded statistics.
+DLLSAMPLE_API void dsp_reset_stats();
+
+// The recording of the delivered quotes and trades for the deterministic replay. The recording is a binary file of
+// blocks appended one by one: every delivered batch with the time it was delivered to the plugin, and the names of its
+// symbols. A recording interrupted by a crash is readable up to the last complete block.
+
+typedef int (*dsp_start_recording_fn_t)(const char *);
+
+// Starts recording the quote and trade batches into the file (truncated), after they are dispatched to the listeners.
+// The batches are copied on the dispatch threads and written to the file by a background thread. Stops the current
+// recording. Returns 1 on success or 0 if the file can't be created.
+DLLSAMPLE_API int dsp_start_recording(const char *file_name);
+
+typedef int (*dsp_stop_recording_fn_t)();
+
+// Stops the recording and closes the file. The recording stops by itself at the first failed write (e.g. the disk is
+// full). Returns 1 if the recording was written completely or 0 if a write failed (the file is readable up to the last
+// complete block).
+DLLSAMPLE_API int dsp_stop_recording();
+
+// The replay of a recording. The file is memory-mapped and the replayed events point into the mapping (nothing is
+// copied). The symbol ids of the replayed events are the ids of the recording: see dsp_replay_symbol_name().
+typedef struct dsp_replay_t dsp_replay_t;
+
+typedef dsp_replay_t *(*dsp_open_replay_fn_t)(const char *);
+
+// Maps and checks the recording. Returns NULL if the file can't be mapped, is not a recording or is damaged.
+DLLSAMPLE_API dsp_replay_t *dsp_open_replay(const char *file_name);
+
+typedef const char *(*dsp_replay_symbol_name_fn_t)(const dsp_replay_t *, uint32_t);
+
+// Returns the symbol of a replayed event by its id or NULL if the id is unknown. The string stays valid until the
+// replay is closed.
+DLLSAMPLE_API const char *dsp_replay_symbol_name(const dsp_replay_t *replay, uint32_t symbol_id);
+
+typedef uint64_t (*dsp_replay_fn_t)(const dsp_replay_t *, double, dsp_events_listener_t, void *);
+
+// Delivers all the recorded batches to the listener on the calling thread and returns the number of the delivered
+// events. `speed` is relative to the recording: 1 replays at the recorded pace, 10 ten times faster and 0 as fast as
+// possible. The events point into the copy-on-write mapping and are valid only during the call of the listener. The
+// listener may modify them: the changes are never written to the file, but the next dsp_replay() of the same replay
+// sees them and skips the rest of a batch at an event that is not valid anymore. May be called again. Returns 0 on
+// failure.
+DLLSAMPLE_API uint64_t dsp_replay(const dsp_replay_t *replay, double speed, dsp_events_listener_t events_listener,
+                                  void *user_data);
+
+typedef void (*dsp_close_replay_fn_t)(dsp_replay_t *);
+
+// Unmaps the recording. Must not be called during dsp_replay().
+DLLSAMPLE_API void dsp_close_replay(dsp_replay_t *replay);
+
 typedef void (*dsp_deinit_fn_t)();
 
+// Applies the pending symbol changes. Must be called before the plugin is unloaded.
+
 DLLSAMPLE_API void dsp_deinit();
 
 #ifdef __cplusplus
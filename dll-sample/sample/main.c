@@ -1,84 +1,661 @@
 // Copyright (c) 2024 Devexperts LLC.
 // SPDX-License-Identifier: MPL-2.0
 
+#ifndef _WIN32
+// clock_gettime(), nanosleep()
+#    define _POSIX_C_SOURCE 200112L
+#endif
+
 #include <plugin-api.h>
 
-#define UNICODE
-#define WIN32_LEAN_AND_MEAN
+#include "output-sink.h"
+
+#ifdef _WIN32
+#    define UNICODE
+#    define WIN32_LEAN_AND_MEAN
 
-#include "Windows.h"
+#    include "Windows.h"
+#else
+#    include <dlfcn.h>
+#    include <time.h>
+#endif
+
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The portable loading of the plugin, timing and atomics.
+
+#ifdef _WIN32
+typedef HMODULE plugin_handle_t;
+
+static plugin_handle_t load_plugin(void) {
+    return LoadLibrary(L"dllsample-dxfeed-plugin.dll");
+}
+
+static void *find_function(plugin_handle_t plugin_handle, const char *name) {
+    return (void *)(GetProcAddress(plugin_handle, name));
+}
+
+static void unload_plugin(plugin_handle_t plugin_handle) {
+    FreeLibrary(plugin_handle);
+}
+
+static void sleep_ms(uint32_t ms) {
+    Sleep(ms);
+}
+
+// Monotonic.
+static uint64_t now_ns(void) {
+    static LARGE_INTEGER frequency = {0};
+    LARGE_INTEGER counter;
+
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+
+    QueryPerformanceCounter(&counter);
+
+    return (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000000ULL +
+           (uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000000ULL / (uint64_t)frequency.QuadPart;
+}
+
+static void atomic_add(volatile uint64_t *target, uint64_t value) {
+    InterlockedExchangeAdd64((volatile LONG64 *)target, (LONG64)value);
+}
+
+static uint64_t atomic_load(volatile uint64_t *target) {
+    return (uint64_t)InterlockedOr64((volatile LONG64 *)target, 0);
+}
+#else
+typedef void *plugin_handle_t;
+
+// The build copies the plugin (built without the live feed) next to the sample.
+static plugin_handle_t load_plugin(void) {
+    return dlopen("./libdllsample-dxfeed-plugin.so", RTLD_NOW | RTLD_LOCAL);
+}
+
+static void *find_function(plugin_handle_t plugin_handle, const char *name) {
+    return dlsym(plugin_handle, name);
+}
 
+static void unload_plugin(plugin_handle_t plugin_handle) {
+    dlclose(plugin_handle);
+}
+
+static void sleep_ms(uint32_t ms) {
+    struct timespec duration = {(time_t)(ms / 1000), (long)(ms % 1000) * 1000000L};
+
+    nanosleep(&duration, NULL);
+}
+
+// Monotonic.
+static uint64_t now_ns(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+static void atomic_add(volatile uint64_t *target, uint64_t value) {
+    __atomic_fetch_add(target, value, __ATOMIC_RELAXED);
+}
+
+static uint64_t atomic_load(volatile uint64_t *target) {
+    return __atomic_load_n(target, __ATOMIC_RELAXED);
+}
+#endif
+
+static dsp_symbol_name_fn_t get_symbol_name = NULL;
+
+// The replayed events have the symbol ids of the recording.
+static dsp_replay_symbol_name_fn_t dsp_replay_symbol_name_fn = NULL;
+static dsp_replay_t *replay = NULL;
+
+static const char *get_replay_symbol_name(uint32_t symbol_id) {
+    return dsp_replay_symbol_name_fn(replay, symbol_id);
+}
+
+// Formats the events without the I/O on the feed thread: the sink writes them on its own thread.
 void listener(dsp_event_t **events, size_t size, void *user_data) {
     if (size == 0 || events == NULL) {
         return;
     }
 
-    char *symbol = user_data == NULL ? "" : (char *)(user_data);
+    output_sink_write_events((output_sink_t *)user_data, events, size);
+}
+
+// The benchmark mode: the events are counted (not printed) and the time spent in the listener is measured.
+
+// The log-linear histogram of the listener times in nanoseconds: 8 buckets per power of two (precise within ~12%).
+#define BENCH_SUB_BUCKET_BITS 3
+#define BENCH_BUCKETS (64 << BENCH_SUB_BUCKET_BITS)
+
+typedef struct bench_counters_t {
+    volatile uint64_t events[DSP_ET_COUNT];
+    volatile uint64_t batches;
+    volatile uint64_t listener_ns[BENCH_BUCKETS];
+    volatile uint64_t listener_max_ns;
+} bench_counters_t;
+
+static bench_counters_t bench_counters;
+// The result of the processing of the events, so it can't be optimized away.
+static volatile double bench_checksum;
+
+static size_t bench_bucket_of(uint64_t value) {
+    size_t exponent = 0;
+
+    if (value < (1u << BENCH_SUB_BUCKET_BITS)) {
+        return (size_t)value;
+    }
+
+    while ((value >> exponent) >= (2u << BENCH_SUB_BUCKET_BITS)) {
+        exponent++;
+    }
+
+    return ((exponent + 1) << BENCH_SUB_BUCKET_BITS) +
+           (size_t)((value >> exponent) & ((1u << BENCH_SUB_BUCKET_BITS) - 1));
+}
+
+static uint64_t bench_highest_value_of(size_t bucket) {
+    size_t exponent = 0;
+    uint64_t sub_bucket = bucket & ((1u << BENCH_SUB_BUCKET_BITS) - 1);
+
+    if (bucket < (1u << BENCH_SUB_BUCKET_BITS)) {
+        return bucket;
+    }
+
+    exponent = (bucket >> BENCH_SUB_BUCKET_BITS) - 1;
+
+    return (((uint64_t)(1u << BENCH_SUB_BUCKET_BITS) + sub_bucket + 1) << exponent) - 1;
+}
+
+static uint64_t bench_percentile(const uint64_t *buckets, double percentile) {
+    uint64_t total = 0;
+    uint64_t seen = 0;
+
+    for (size_t i = 0; i < BENCH_BUCKETS; i++) {
+        total += buckets[i];
+    }
+
+    for (size_t i = 0; i < BENCH_BUCKETS; i++) {
+        seen += buckets[i];
+
+        if (total != 0 && (double)seen >= percentile * (double)total) {
+            return bench_highest_value_of(i);
+        }
+    }
 
+    return 0;
+}
+
+void bench_listener(dsp_event_t **events, size_t size, void *user_data) {
+    uint64_t start = now_ns();
+    uint64_t counts[DSP_ET_COUNT] = {0};
+    double checksum = 0;
+
+    (void)user_data;
+
+    // The typical processing: the mid prices of the quotes and the notionals of the trades.
     for (size_t i = 0; i < size; i++) {
         if (events[i]->type == DSP_ET_QUOTE) {
-            dsp_quote_t *q = (dsp_quote_t *)(events[i]);
+            const dsp_quote_t *q = (const dsp_quote_t *)(events[i]);
 
-            printf("Quote{%s, bid_price = %.15g, bid_size = %.15g, ask_price = %.15g, ask_size = %.15g}\n", symbol,
-                   q->bid_price, q->bid_size, q->ask_price, q->ask_size);
+            checksum += (q->bid_price + q->ask_price) * 0.5;
         } else if (events[i]->type == DSP_ET_TRADE) {
-            dsp_trade_t *tr = (dsp_trade_t *)(events[i]);
+            const dsp_trade_t *tr = (const dsp_trade_t *)(events[i]);
+
+            checksum += tr->price * tr->size;
+        }
 
-            printf("Trade{%s, price = %.15g, size = %.15g, dayVolume = %.15g}\n", symbol, tr->price, tr->size,
-                   tr->dayVolume);
+        if ((uint32_t)events[i]->type < DSP_ET_COUNT) {
+            counts[events[i]->type]++;
         }
     }
+
+    bench_checksum = checksum;
+
+    for (size_t type = 0; type < DSP_ET_COUNT; type++) {
+        if (counts[type] != 0) {
+            atomic_add(&bench_counters.events[type], counts[type]);
+        }
+    }
+
+    uint64_t elapsed = now_ns() - start;
+    uint64_t max = atomic_load(&bench_counters.listener_max_ns);
+
+    atomic_add(&bench_counters.batches, 1);
+    atomic_add(&bench_counters.listener_ns[bench_bucket_of(elapsed)], 1);
+
+    // Racy, but the maximum is only reported.
+    if (elapsed > max) {
+        bench_counters.listener_max_ns = elapsed;
+    }
+}
+
+static const char *const bench_event_type_names[DSP_ET_COUNT] = {
+    "quote", "trade", "time_and_sale", "order", "summary", "profile", "candle",
+};
+
+static void bench_free_symbols(char **symbols, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        free(symbols[i]);
+    }
+
+    free(symbols);
+}
+
+// Reads the symbols of the file: one symbol per line, the empty lines and the lines starting with '#' are skipped.
+// Returns the number of symbols or 0 on failure (nothing is left allocated then).
+static size_t bench_read_symbols(const char *file_name, char ***symbols) {
+    FILE *file = fopen(file_name, "r");
+    char line[1024];
+    char **read = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+
+    *symbols = NULL;
+
+    if (file == NULL) {
+        return 0;
+    }
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        size_t length = strcspn(line, "\r\n");
+        char *symbol = NULL;
+
+        line[length] = '\0';
+
+        if (length == 0 || line[0] == '#') {
+            continue;
+        }
+
+        if (count == capacity) {
+            size_t new_capacity = capacity == 0 ? 1024 : capacity * 2;
+            char **grown = (char **)realloc(read, new_capacity * sizeof(char *));
+
+            if (grown == NULL) {
+                break;
+            }
+
+            read = grown;
+            capacity = new_capacity;
+        }
+
+        symbol = (char *)malloc(length + 1);
+
+        if (symbol == NULL) {
+            break;
+        }
+
+        memcpy(symbol, line, length + 1);
+        read[count++] = symbol;
+    }
+
+    // Stopped early: out of memory or a read error.
+    if (!feof(file)) {
+        fprintf(stderr, "Failed to read the symbols of %s\n", file_name);
+        fclose(file);
+        bench_free_symbols(read, count);
+
+        return 0;
+    }
+
+    fclose(file);
+    *symbols = read;
+
+    return count;
+}
+
+static void bench_print_stats(dsp_get_stats_fn_t dsp_get_stats) {
+    dsp_stats_t stats;
+
+    memset(&stats, 0, sizeof(stats));
+    stats.struct_size = sizeof(dsp_stats_t);
+
+    if (dsp_get_stats == NULL || !dsp_get_stats(&stats)) {
+        return;
+    }
+
+    printf("  plugin marshal:  p50 = %llu ns, p99 = %llu ns, p99.9 = %llu ns, max = %llu ns\n",
+           (unsigned long long)stats.marshal.p50_ns, (unsigned long long)stats.marshal.p99_ns,
+           (unsigned long long)stats.marshal.p999_ns, (unsigned long long)stats.marshal.max_ns);
+    printf("  plugin dispatch: p50 = %llu ns, p99 = %llu ns, p99.9 = %llu ns, max = %llu ns\n",
+           (unsigned long long)stats.dispatch.p50_ns, (unsigned long long)stats.dispatch.p99_ns,
+           (unsigned long long)stats.dispatch.p999_ns, (unsigned long long)stats.dispatch.max_ns);
+    printf("  plugin total:    p50 = %llu ns, p99 = %llu ns, p99.9 = %llu ns, max = %llu ns\n",
+           (unsigned long long)stats.total.p50_ns, (unsigned long long)stats.total.p99_ns,
+           (unsigned long long)stats.total.p999_ns, (unsigned long long)stats.total.max_ns);
+
+    // The events without an event time (e.g. of the synthetic source) are not counted in the lag.
+    if (stats.lag.count == 0) {
+        printf("  feed lag:        n/a (no event times)\n");
+
+        return;
+    }
+
+    printf("  feed lag:        p50 = %llu ns, p99 = %llu ns, p99.9 = %llu ns, max = %llu ns\n",
+           (unsigned long long)stats.lag.p50_ns, (unsigned long long)stats.lag.p99_ns,
+           (unsigned long long)stats.lag.p999_ns, (unsigned long long)stats.lag.max_ns);
+}
+
+// Prints the events per second by type since the previous report, and the listener time percentiles so far.
+static void bench_print_report(const char *title, double seconds, const uint64_t *events, uint64_t batches) {
+    uint64_t buckets[BENCH_BUCKETS];
+    uint64_t total = 0;
+
+    for (size_t i = 0; i < BENCH_BUCKETS; i++) {
+        buckets[i] = atomic_load(&bench_counters.listener_ns[i]);
+    }
+
+    for (size_t type = 0; type < DSP_ET_COUNT; type++) {
+        total += events[type];
+    }
+
+    printf("%s: %.1f s, %llu events, %.0f events/s, %llu batches", title, seconds, (unsigned long long)total,
+           seconds > 0 ? (double)total / seconds : 0.0, (unsigned long long)batches);
+
+    for (size_t type = 0; type < DSP_ET_COUNT; type++) {
+        if (events[type] != 0) {
+            printf(", %s %.0f/s", bench_event_type_names[type], seconds > 0 ? (double)events[type] / seconds : 0.0);
+        }
+    }
+
+    printf("; listener p50 = %llu ns, p99 = %llu ns, p99.9 = %llu ns, max = %llu ns\n",
+           (unsigned long long)bench_percentile(buckets, 0.5), (unsigned long long)bench_percentile(buckets, 0.99),
+           (unsigned long long)bench_percentile(buckets, 0.999),
+           (unsigned long long)atomic_load(&bench_counters.listener_max_ns));
+}
+
+static int run_bench(plugin_handle_t plugin_handle, const char *address, const char *file_name, uint32_t duration_s) {
+    dsp_connect_fn_t dsp_connect = (dsp_connect_fn_t)(find_function(plugin_handle, "dsp_connect"));
+    dsp_subscribe_many_fn_t dsp_subscribe_many =
+        (dsp_subscribe_many_fn_t)(find_function(plugin_handle, "dsp_subscribe_many"));
+    dsp_get_stats_fn_t dsp_get_stats = (dsp_get_stats_fn_t)(find_function(plugin_handle, "dsp_get_stats"));
+    char **symbols = NULL;
+    size_t count = 0;
+    uint64_t previous[DSP_ET_COUNT] = {0};
+    uint64_t previous_batches = 0;
+
+    if (dsp_connect == NULL || dsp_subscribe_many == NULL) {
+        return 5;
+    }
+
+    count = bench_read_symbols(file_name, &symbols);
+
+    if (count == 0) {
+        fprintf(stderr, "No symbols in %s\n", file_name);
+
+        return 3;
+    }
+
+    printf("Subscribing to %zu symbols\n", count);
+
+    if (!dsp_subscribe_many((const char *const *)symbols, count, DSP_EVENT_TYPE_MASK_DEFAULT, bench_listener, NULL)) {
+        fprintf(stderr, "Failed to subscribe to the symbols of %s\n", file_name);
+        bench_free_symbols(symbols, count);
+
+        return 7;
+    }
+
+    printf("Connecting to %s for %u s\n", address, duration_s);
+
+    uint64_t start = now_ns();
+    uint64_t previous_time = start;
+
+    dsp_connect(address);
+
+    // The periodic reports every second.
+    for (uint32_t second = 0; second < duration_s; second++) {
+        uint64_t events[DSP_ET_COUNT];
+        uint64_t batches = 0;
+        uint64_t now = 0;
+
+        sleep_ms(1000);
+        now = now_ns();
+
+        for (size_t type = 0; type < DSP_ET_COUNT; type++) {
+            uint64_t total = atomic_load(&bench_counters.events[type]);
+
+            events[type] = total - previous[type];
+            previous[type] = total;
+        }
+
+        batches = atomic_load(&bench_counters.batches);
+        bench_print_report("interval", (double)(now - previous_time) / 1e9, events, batches - previous_batches);
+        previous_batches = batches;
+        previous_time = now;
+    }
+
+    uint64_t totals[DSP_ET_COUNT];
+
+    for (size_t type = 0; type < DSP_ET_COUNT; type++) {
+        totals[type] = atomic_load(&bench_counters.events[type]);
+    }
+
+    bench_print_report("total", (double)(now_ns() - start) / 1e9, totals, atomic_load(&bench_counters.batches));
+    bench_print_stats(dsp_get_stats);
+    bench_free_symbols(symbols, count);
+
+    return 0;
+}
+
+// Replays the recording into the sink on the calling thread.
+static int run_replay(plugin_handle_t plugin_handle, const char *file_name, double speed, output_sink_format_t format,
+                      const char *output) {
+    dsp_open_replay_fn_t dsp_open_replay = (dsp_open_replay_fn_t)(find_function(plugin_handle, "dsp_open_replay"));
+    dsp_replay_fn_t dsp_replay = (dsp_replay_fn_t)(find_function(plugin_handle, "dsp_replay"));
+    dsp_close_replay_fn_t dsp_close_replay = (dsp_close_replay_fn_t)(find_function(plugin_handle, "dsp_close_replay"));
+    FILE *report = format == OUTPUT_SINK_FORMAT_BINARY && output == NULL ? stderr : stdout;
+
+    dsp_replay_symbol_name_fn =
+        (dsp_replay_symbol_name_fn_t)(find_function(plugin_handle, "dsp_replay_symbol_name"));
+
+    if (dsp_open_replay == NULL || dsp_replay == NULL || dsp_close_replay == NULL ||
+        dsp_replay_symbol_name_fn == NULL) {
+        return 5;
+    }
+
+    replay = dsp_open_replay(file_name);
+
+    if (replay == NULL) {
+        fprintf(stderr, "Can't replay %s\n", file_name);
+
+        return 3;
+    }
+
+    output_sink_t *sink = output_sink_open(output, format, 0, get_replay_symbol_name);
+
+    if (sink == NULL) {
+        dsp_close_replay(replay);
+
+        return 3;
+    }
+
+    uint64_t start = now_ns();
+    uint64_t replayed = dsp_replay(replay, speed, listener, sink);
+    double seconds = (double)(now_ns() - start) / 1e9;
+    uint64_t written = output_sink_get_written_count(sink);
+    uint64_t dropped = output_sink_get_dropped_count(sink);
+
+    // The listener is called only by dsp_replay(), and the sink resolves the symbols until it's closed.
+    output_sink_close(sink);
+    dsp_close_replay(replay);
+    replay = NULL;
+
+    fprintf(report, "Replayed: %llu in %.3f s, written: %llu, dropped: %llu\n", (unsigned long long)replayed, seconds,
+            (unsigned long long)written, (unsigned long long)dropped);
+
+    return 0;
 }
 
 int main(int argc, char **argv) {
     if (argc == 2 && (strcmp("-?", argv[1]) == 0 || strcmp("-h", argv[1]) == 0)) {
-        printf("Usage: %s <address> <symbol>\n"
+        printf("Usage: %s [--format=text|binary] [--output=<file>] [--record=<recording>] <address> <symbol>\n"
+               "       %s [--format=text|binary] [--output=<file>] --replay <recording> [<speed>]\n"
+               "       %s --bench <symbols-file> [<duration>] [<address>]\n"
                "Where:\n\n"
-               "<address> - data source address (demo.dxfeed.com:7300 etc),\n"
-               "            demo.dxfeed.com:7300 - default\n"
-               "<symbol>  - security symbol (e.g. IBM, AAPL, SPX etc.), AAPL - default\n\n"
-               "Example: dllsample-sample demo.dxfeed.com:7300 AAPL\n\n",
-               argv[0]);
+               "<address>      - data source address (demo.dxfeed.com:7300, synthetic:symbols=1000 etc),\n"
+               "                 demo.dxfeed.com:7300 - default\n"
+               "<symbol>       - security symbol (e.g. IBM, AAPL, SPX etc.), AAPL - default\n"
+               "--format       - the format of the events: the text lines (the default) or the binary records\n"
+               "                 (see output-sink.h)\n"
+               "--output       - the file to write the events to, the standard output - default\n"
+               "--record       - the file to record the delivered quotes and trades to, for the replay\n"
+               "<recording>    - the file recorded by --record\n"
+               "<speed>        - the speed of the replay: 1 - the recorded pace, 10 - ten times faster,\n"
+               "                 0 - as fast as possible (default)\n"
+               "<symbols-file> - the file with the symbols to subscribe to, one per line\n"
+               "<duration>     - the duration of the benchmark in seconds, 60 - default\n\n"
+               "The benchmark mode counts the quotes and trades without printing them and prints the throughput and\n"
+               "the listener time every second and the final report with the plugin statistics.\n\n"
+               "Example: dllsample-sample demo.dxfeed.com:7300 AAPL\n"
+               "         dllsample-sample --record=aapl.ticks demo.dxfeed.com:7300 AAPL\n"
+               "         dllsample-sample --replay aapl.ticks 1\n"
+               "         dllsample-sample --bench symbols.txt 30 synthetic:symbols=10000,rate=1000000\n\n",
+               argv[0], argv[0], argv[0]);
 
         return 0;
     }
 
-    HMODULE plugin_handle = LoadLibrary(L"dllsample-dxfeed-plugin.dll");
+    plugin_handle_t plugin_handle = load_plugin();
 
     if (plugin_handle == NULL) {
         return 42;
     }
 
-    dsp_init_fn_t dsp_init = (dsp_init_fn_t)(GetProcAddress(plugin_handle, "dsp_init"));
-    dsp_connect_fn_t dsp_connect = (dsp_connect_fn_t)(GetProcAddress(plugin_handle, "dsp_connect"));
-    dsp_subscribe_fn_t dsp_subscribe = (dsp_subscribe_fn_t)(GetProcAddress(plugin_handle, "dsp_subscribe"));
-    dsp_deinit_fn_t dsp_deinit = (dsp_deinit_fn_t)(GetProcAddress(plugin_handle, "dsp_deinit"));
+    dsp_get_api_version_fn_t dsp_get_api_version =
+        (dsp_get_api_version_fn_t)(find_function(plugin_handle, "dsp_get_api_version"));
+
+    if (dsp_get_api_version == NULL || dsp_get_api_version() != DSP_API_VERSION) {
+        unload_plugin(plugin_handle);
+
+        return 6;
+    }
+
+    dsp_init_fn_t dsp_init = (dsp_init_fn_t)(find_function(plugin_handle, "dsp_init"));
+    dsp_connect_fn_t dsp_connect = (dsp_connect_fn_t)(find_function(plugin_handle, "dsp_connect"));
+    dsp_subscribe_fn_t dsp_subscribe = (dsp_subscribe_fn_t)(find_function(plugin_handle, "dsp_subscribe"));
+    dsp_deinit_fn_t dsp_deinit = (dsp_deinit_fn_t)(find_function(plugin_handle, "dsp_deinit"));
 
-    if (dsp_init == NULL || dsp_connect == NULL || dsp_subscribe == NULL || dsp_deinit == NULL) {
-        FreeLibrary(plugin_handle);
+    get_symbol_name = (dsp_symbol_name_fn_t)(find_function(plugin_handle, "dsp_symbol_name"));
+
+    if (dsp_init == NULL || dsp_connect == NULL || dsp_subscribe == NULL || dsp_deinit == NULL ||
+        get_symbol_name == NULL) {
+        unload_plugin(plugin_handle);
 
         return 5;
     }
 
+    if (argc > 2 && strcmp("--bench", argv[1]) == 0) {
+        uint32_t duration_s = argc > 3 ? (uint32_t)strtoul(argv[3], NULL, 10) : 60;
+        const char *address = argc > 4 ? argv[4] : "demo.dxfeed.com:7300";
+        int result = run_bench(plugin_handle, address, argv[2], duration_s);
+
+        dsp_deinit();
+        unload_plugin(plugin_handle);
+
+        return result;
+    }
+
+    output_sink_format_t format = OUTPUT_SINK_FORMAT_TEXT;
+    const char *output = NULL;
+    const char *recording = NULL;
+    int arg = 1;
+
+    for (; arg < argc && strncmp("--", argv[arg], 2) == 0; arg++) {
+        if (strcmp("--format=binary", argv[arg]) == 0) {
+            format = OUTPUT_SINK_FORMAT_BINARY;
+        } else if (strncmp("--output=", argv[arg], 9) == 0) {
+            output = argv[arg] + 9;
+        } else if (strncmp("--record=", argv[arg], 9) == 0) {
+            recording = argv[arg] + 9;
+        } else if (strcmp("--replay", argv[arg]) == 0 && arg + 1 < argc) {
+            double speed = arg + 2 < argc ? strtod(argv[arg + 2], NULL) : 0;
+            int result = run_replay(plugin_handle, argv[arg + 1], speed, format, output);
+
+            dsp_deinit();
+            unload_plugin(plugin_handle);
+
+            return result;
+        }
+    }
+
     char *address = "demo.dxfeed.com:7300";
     char *symbol = "AAPL";
 
-    if (argc > 1) {
-        address = argv[1];
+    if (argc > arg) {
+        address = argv[arg];
+    }
+
+    if (argc > arg + 1) {
+        symbol = argv[arg + 1];
     }
 
-    if (argc > 2) {
-        symbol = argv[2];
+    // The binary records on the standard output are followed by nothing else.
+    FILE *report = format == OUTPUT_SINK_FORMAT_BINARY && output == NULL ? stderr : stdout;
+
+    fprintf(report, "Connecting to %s\n", address);
+    fprintf(report, "Subscribing to %s\n", symbol);
+
+    output_sink_t *sink = output_sink_open(output, format, 0, get_symbol_name);
+
+    if (sink == NULL) {
+        unload_plugin(plugin_handle);
+
+        return 3;
+    }
+
+    dsp_start_recording_fn_t dsp_start_recording =
+        (dsp_start_recording_fn_t)(find_function(plugin_handle, "dsp_start_recording"));
+    dsp_stop_recording_fn_t dsp_stop_recording =
+        (dsp_stop_recording_fn_t)(find_function(plugin_handle, "dsp_stop_recording"));
+
+    if (recording != NULL && (dsp_start_recording == NULL || !dsp_start_recording(recording))) {
+        fprintf(stderr, "Can't record to %s\n", recording);
     }
 
-    printf("Connecting to %s\n", address);
     dsp_connect(address);
-    printf("Subscribing to %s\n", symbol);
-    dsp_subscribe(symbol, listener, symbol);
+    dsp_subscribe(symbol, listener, sink);
 
-    Sleep(10000);
-    FreeLibrary(plugin_handle);
+    sleep_ms(10000);
+
+    if (recording != NULL && dsp_stop_recording != NULL && !dsp_stop_recording()) {
+        fprintf(stderr, "Can't write the recording to %s\n", recording);
+    }
+
+    dsp_get_stats_fn_t dsp_get_stats = (dsp_get_stats_fn_t)(find_function(plugin_handle, "dsp_get_stats"));
+    dsp_stats_t stats;
+    int has_stats = 0;
+
+    memset(&stats, 0, sizeof(stats));
+    stats.struct_size = sizeof(dsp_stats_t);
+    has_stats = dsp_get_stats != NULL && dsp_get_stats(&stats);
+
+    dsp_deinit();
+    // The listener may be called until the plugin is unloaded.
+    unload_plugin(plugin_handle);
+
+    uint64_t written = output_sink_get_written_count(sink);
+    uint64_t dropped = output_sink_get_dropped_count(sink);
+
+    output_sink_close(sink);
+    fprintf(report, "Written: %llu, dropped: %llu\n", (unsigned long long)written, (unsigned long long)dropped);
+
+    if (has_stats) {
+        fprintf(report, "Batches: %llu, total p50 = %llu ns, p99 = %llu ns, p99.9 = %llu ns, max = %llu ns\n",
+                (unsigned long long)stats.total.count, (unsigned long long)stats.total.p50_ns,
+                (unsigned long long)stats.total.p99_ns, (unsigned long long)stats.total.p999_ns,
+                (unsigned long long)stats.total.max_ns);
+
+        if (stats.lag.count != 0) {
+            fprintf(report, "Events with a time: %llu, lag p50 = %llu ns, p99 = %llu ns, max = %llu ns\n",
+                    (unsigned long long)stats.lag.count, (unsigned long long)stats.lag.p50_ns,
+                    (unsigned long long)stats.lag.p99_ns, (unsigned long long)stats.lag.max_ns);
+        }
+    }
 
     return 0;
 }
@@ -0,0 +1,590 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#ifndef _WIN32
+// nanosleep(), strnlen()
+#    define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "output-sink.h"
+
+#ifdef _WIN32
+#    define WIN32_LEAN_AND_MEAN
+
+#    include "Windows.h"
+#    include <fcntl.h>
+#    include <io.h>
+#    include <sys/stat.h>
+#else
+#    include <fcntl.h>
+#    include <pthread.h>
+#    include <time.h>
+#    include <unistd.h>
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The maximal number of the threads that write to a sink; the events of the other threads are dropped.
+#define OUTPUT_SINK_MAX_LANES 16
+#define OUTPUT_SINK_DEFAULT_BUFFER_SIZE ((size_t)4 << 20)
+// The writer flushes the buffers this often, or at once if a buffer is half full.
+#define OUTPUT_SINK_FLUSH_INTERVAL_MS 5
+// The longer symbol names are truncated.
+#define OUTPUT_SINK_MAX_SYMBOL 256
+// The longest record: a quote with the longest symbol name (text), or an event with the definition of its symbol.
+#define OUTPUT_SINK_MAX_RECORD 512
+#define OUTPUT_SINK_STDOUT 1
+
+// The portable threads, atomics and I/O.
+
+#ifdef _WIN32
+#    define OUTPUT_SINK_THREAD_LOCAL __declspec(thread)
+
+typedef HANDLE output_sink_thread_t;
+
+static uint64_t load_acquire(volatile uint64_t *target) {
+    return (uint64_t)InterlockedCompareExchange64((volatile LONG64 *)target, 0, 0);
+}
+
+static void store_release(volatile uint64_t *target, uint64_t value) {
+    InterlockedExchange64((volatile LONG64 *)target, (LONG64)value);
+}
+
+static uint64_t fetch_add(volatile uint64_t *target, uint64_t value) {
+    return (uint64_t)InterlockedExchangeAdd64((volatile LONG64 *)target, (LONG64)value);
+}
+
+static void sleep_ms(uint32_t ms) {
+    Sleep(ms);
+}
+
+static int open_file(const char *file_name) {
+    return _open(file_name, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+}
+
+static void close_file(int fd) {
+    _close(fd);
+}
+
+static int write_chunk(int fd, const char *data, size_t size) {
+    return _write(fd, data, (unsigned int)(size > 0x40000000 ? 0x40000000 : size));
+}
+#else
+#    define OUTPUT_SINK_THREAD_LOCAL _Thread_local
+
+typedef pthread_t output_sink_thread_t;
+
+static uint64_t load_acquire(volatile uint64_t *target) {
+    return __atomic_load_n(target, __ATOMIC_ACQUIRE);
+}
+
+static void store_release(volatile uint64_t *target, uint64_t value) {
+    __atomic_store_n(target, value, __ATOMIC_RELEASE);
+}
+
+static uint64_t fetch_add(volatile uint64_t *target, uint64_t value) {
+    return __atomic_fetch_add(target, value, __ATOMIC_RELAXED);
+}
+
+static void sleep_ms(uint32_t ms) {
+    struct timespec duration = {(time_t)(ms / 1000), (long)(ms % 1000) * 1000000L};
+
+    nanosleep(&duration, NULL);
+}
+
+static int open_file(const char *file_name) {
+    return open(file_name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+}
+
+static void close_file(int fd) {
+    close(fd);
+}
+
+static int write_chunk(int fd, const char *data, size_t size) {
+    return (int)write(fd, data, size > 0x40000000 ? 0x40000000 : size);
+}
+#endif
+
+// The buffer of one thread: a single-producer single-consumer ring of the formatted records.
+typedef struct output_sink_lane_t {
+    // Set by the producer when the buffer is allocated.
+    volatile uint64_t ready;
+    char *buffer;
+    // Written by the writer thread.
+    volatile uint64_t head;
+    // Keeps the head and the tail on the different cache lines.
+    char padding[64];
+    // Written by the producer: the end of the last batch.
+    volatile uint64_t tail;
+    // The symbol ids already defined in the lane (OUTPUT_SINK_FORMAT_BINARY), a bit per id. The producer only.
+    uint8_t *defined_symbols;
+    size_t defined_symbols_size;
+} output_sink_lane_t;
+
+struct output_sink_t {
+    uint64_t id;
+    output_sink_format_t format;
+    output_sink_symbol_name_fn_t symbol_name;
+    int fd;
+    // Unless the standard output.
+    int owns_fd;
+    size_t capacity;
+    volatile uint64_t stopped;
+    volatile uint64_t lane_count;
+    volatile uint64_t dropped;
+    volatile uint64_t written;
+    output_sink_thread_t writer;
+    output_sink_lane_t lanes[OUTPUT_SINK_MAX_LANES];
+};
+
+// The ids of the sinks: a thread caches its lane of the last sink it wrote to.
+static volatile uint64_t last_sink_id = 0;
+static OUTPUT_SINK_THREAD_LOCAL uint64_t cached_sink_id = 0;
+static OUTPUT_SINK_THREAD_LOCAL output_sink_lane_t *cached_lane = NULL;
+
+static void write_fully(output_sink_t *sink, const char *data, size_t size) {
+    while (size > 0) {
+        int written = write_chunk(sink->fd, data, size);
+
+        // The output is broken: the records are lost.
+        if (written <= 0) {
+            return;
+        }
+
+        data += written;
+        size -= (size_t)written;
+    }
+}
+
+// Writes the records of every lane. Returns 1 if a lane was at least half full.
+static int flush_lanes(output_sink_t *sink) {
+    uint64_t lane_count = load_acquire(&sink->lane_count);
+    int busy = 0;
+
+    for (size_t i = 0; i < lane_count && i < OUTPUT_SINK_MAX_LANES; i++) {
+        output_sink_lane_t *lane = &sink->lanes[i];
+
+        if (!load_acquire(&lane->ready)) {
+            continue;
+        }
+
+        uint64_t head = lane->head;
+        uint64_t tail = load_acquire(&lane->tail);
+        size_t size = (size_t)(tail - head);
+        size_t start = (size_t)(head & (sink->capacity - 1));
+        size_t first = size < sink->capacity - start ? size : sink->capacity - start;
+
+        if (size == 0) {
+            continue;
+        }
+
+        busy |= size >= sink->capacity / 2;
+
+        // Only the whole batches are published, so the records of the lanes are never mixed.
+        write_fully(sink, lane->buffer + start, first);
+
+        if (size > first) {
+            write_fully(sink, lane->buffer, size - first);
+        }
+
+        store_release(&lane->head, tail);
+    }
+
+    return busy;
+}
+
+static void run_writer(output_sink_t *sink) {
+    while (!load_acquire(&sink->stopped)) {
+        if (!flush_lanes(sink)) {
+            sleep_ms(OUTPUT_SINK_FLUSH_INTERVAL_MS);
+        }
+    }
+
+    flush_lanes(sink);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI writer_thread(LPVOID sink) {
+    run_writer((output_sink_t *)sink);
+
+    return 0;
+}
+
+static int start_writer(output_sink_t *sink) {
+    sink->writer = CreateThread(NULL, 0, writer_thread, sink, 0, NULL);
+
+    return sink->writer != NULL;
+}
+
+static void join_writer(output_sink_t *sink) {
+    WaitForSingleObject(sink->writer, INFINITE);
+    CloseHandle(sink->writer);
+}
+#else
+static void *writer_thread(void *sink) {
+    run_writer((output_sink_t *)sink);
+
+    return NULL;
+}
+
+static int start_writer(output_sink_t *sink) {
+    return pthread_create(&sink->writer, NULL, writer_thread, sink) == 0;
+}
+
+static void join_writer(output_sink_t *sink) {
+    pthread_join(sink->writer, NULL);
+}
+#endif
+
+// The formatting.
+
+static const double POWERS_OF_10[] = {1e0, 1e1, 1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                      1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+
+// Below 2^53 the doubles represent the integers exactly.
+#define OUTPUT_SINK_EXACT_LIMIT 9007199254740992.0
+
+// Formats `negative` `mantissa` / 10^`decimals`.
+static size_t format_decimal(int negative, uint64_t mantissa, size_t decimals, char *buffer) {
+    char digits[24];
+    size_t count = 0;
+    size_t length = 0;
+
+    do {
+        digits[count++] = (char)('0' + mantissa % 10);
+        mantissa /= 10;
+    } while (mantissa != 0);
+
+    // The leading zeros of the fraction: 0.05
+    while (count <= decimals) {
+        digits[count++] = '0';
+    }
+
+    if (negative) {
+        buffer[length++] = '-';
+    }
+
+    while (count > decimals) {
+        buffer[length++] = digits[--count];
+    }
+
+    if (decimals != 0) {
+        buffer[length++] = '.';
+
+        while (count > 0) {
+            buffer[length++] = digits[--count];
+        }
+    }
+
+    return length;
+}
+
+size_t output_sink_format_double(double value, char *buffer) {
+    double magnitude = fabs(value);
+
+    // The exact decimals with up to 15 digits after the point, where %g wouldn't use the exponent. The fewest decimals
+    // that give the same value are the shortest representation.
+    if (isfinite(value) && magnitude < 1e15 && (magnitude >= 1e-4 || magnitude == 0)) {
+        for (size_t decimals = 0; decimals < sizeof(POWERS_OF_10) / sizeof(POWERS_OF_10[0]); decimals++) {
+            double scaled = magnitude * POWERS_OF_10[decimals];
+
+            if (scaled >= OUTPUT_SINK_EXACT_LIMIT) {
+                break;
+            }
+
+            uint64_t mantissa = (uint64_t)(scaled + 0.5);
+
+            // The mantissa and the power of 10 are exact, so the division is rounded as strtod() would.
+            if ((double)mantissa / POWERS_OF_10[decimals] == magnitude) {
+                return format_decimal(signbit(value) != 0, mantissa, decimals, buffer);
+            }
+        }
+    }
+
+    // The shortest precision that gives the same value (17 digits always do).
+    for (int precision = 15;; precision++) {
+        int length = snprintf(buffer, 32, "%.*g", precision, value);
+
+        if (precision == 17 || strtod(buffer, NULL) == value) {
+            return (size_t)length;
+        }
+    }
+}
+
+static char *append_string(char *position, const char *string, size_t length) {
+    memcpy(position, string, length);
+
+    return position + length;
+}
+
+#define APPEND_LITERAL(position, literal) append_string((position), (literal), sizeof(literal) - 1)
+
+static char *append_double(char *position, double value) {
+    return position + output_sink_format_double(value, position);
+}
+
+static size_t symbol_name_of(output_sink_t *sink, uint32_t symbol_id, const char **name) {
+    *name = sink->symbol_name(symbol_id);
+
+    if (*name == NULL) {
+        *name = "";
+    }
+
+    return strnlen(*name, OUTPUT_SINK_MAX_SYMBOL);
+}
+
+static size_t format_text(output_sink_t *sink, const dsp_event_t *event, char *record) {
+    const char *symbol = NULL;
+    size_t symbol_length = symbol_name_of(sink, event->symbol_id, &symbol);
+    char *position = record;
+
+    if (event->type == DSP_ET_QUOTE) {
+        const dsp_quote_t *q = (const dsp_quote_t *)event;
+
+        position = APPEND_LITERAL(position, "Quote{");
+        position = append_string(position, symbol, symbol_length);
+        position = append_double(APPEND_LITERAL(position, ", bid_price = "), q->bid_price);
+        position = append_double(APPEND_LITERAL(position, ", bid_size = "), q->bid_size);
+        position = append_double(APPEND_LITERAL(position, ", ask_price = "), q->ask_price);
+        position = append_double(APPEND_LITERAL(position, ", ask_size = "), q->ask_size);
+    } else {
+        const dsp_trade_t *tr = (const dsp_trade_t *)event;
+
+        position = APPEND_LITERAL(position, "Trade{");
+        position = append_string(position, symbol, symbol_length);
+        position = append_double(APPEND_LITERAL(position, ", price = "), tr->price);
+        position = append_double(APPEND_LITERAL(position, ", size = "), tr->size);
+        position = append_double(APPEND_LITERAL(position, ", dayVolume = "), tr->dayVolume);
+    }
+
+    position = APPEND_LITERAL(position, "}\n");
+
+    return (size_t)(position - record);
+}
+
+static char *append_header(char *position, size_t size, uint16_t type, uint32_t symbol_id) {
+    output_sink_record_header_t header = {(uint16_t)size, type, symbol_id};
+
+    return append_string(position, (const char *)&header, sizeof(header));
+}
+
+static int is_symbol_defined(const output_sink_lane_t *lane, uint32_t symbol_id) {
+    return symbol_id / 8 < lane->defined_symbols_size && (lane->defined_symbols[symbol_id / 8] >> (symbol_id % 8)) & 1;
+}
+
+static void define_symbol(output_sink_lane_t *lane, uint32_t symbol_id) {
+    if (symbol_id / 8 >= lane->defined_symbols_size) {
+        size_t size = (symbol_id / 8 + 1) * 2;
+        uint8_t *defined_symbols = (uint8_t *)realloc(lane->defined_symbols, size);
+
+        // Defined again next time.
+        if (defined_symbols == NULL) {
+            return;
+        }
+
+        memset(defined_symbols + lane->defined_symbols_size, 0, size - lane->defined_symbols_size);
+        lane->defined_symbols = defined_symbols;
+        lane->defined_symbols_size = size;
+    }
+
+    lane->defined_symbols[symbol_id / 8] |= (uint8_t)(1u << (symbol_id % 8));
+}
+
+// The event, preceded by the definition of its symbol if it's the first event of the symbol in the lane.
+static size_t format_binary(output_sink_t *sink, const output_sink_lane_t *lane, const dsp_event_t *event,
+                            char *record) {
+    char *position = record;
+
+    if (!is_symbol_defined(lane, event->symbol_id)) {
+        const char *symbol = NULL;
+        size_t symbol_length = symbol_name_of(sink, event->symbol_id, &symbol);
+
+        position = append_header(position, sizeof(output_sink_record_header_t) + symbol_length,
+                                 OUTPUT_SINK_RECORD_SYMBOL, event->symbol_id);
+        position = append_string(position, symbol, symbol_length);
+    }
+
+    if (event->type == DSP_ET_QUOTE) {
+        const dsp_quote_t *q = (const dsp_quote_t *)event;
+        double values[] = {q->bid_price, q->bid_size, q->ask_price, q->ask_size};
+
+        position = append_header(position, sizeof(output_sink_record_header_t) + sizeof(values), DSP_ET_QUOTE,
+                                 event->symbol_id);
+        position = append_string(position, (const char *)values, sizeof(values));
+    } else {
+        const dsp_trade_t *tr = (const dsp_trade_t *)event;
+        double values[] = {tr->price, tr->size, tr->dayVolume};
+
+        position = append_header(position, sizeof(output_sink_record_header_t) + sizeof(values), DSP_ET_TRADE,
+                                 event->symbol_id);
+        position = append_string(position, (const char *)values, sizeof(values));
+    }
+
+    return (size_t)(position - record);
+}
+
+// Returns the lane of the current thread or NULL if there are too many threads.
+static output_sink_lane_t *get_lane(output_sink_t *sink) {
+    if (cached_sink_id == sink->id) {
+        return cached_lane;
+    }
+
+    uint64_t index = fetch_add(&sink->lane_count, 1);
+    output_sink_lane_t *lane = NULL;
+
+    if (index < OUTPUT_SINK_MAX_LANES) {
+        lane = &sink->lanes[index];
+        lane->buffer = (char *)malloc(sink->capacity);
+
+        if (lane->buffer != NULL) {
+            store_release(&lane->ready, 1);
+        } else {
+            lane = NULL;
+        }
+    }
+
+    cached_sink_id = sink->id;
+    cached_lane = lane;
+
+    return lane;
+}
+
+output_sink_t *output_sink_open(const char *file_name, output_sink_format_t format, size_t buffer_size,
+                                output_sink_symbol_name_fn_t symbol_name) {
+    output_sink_t *sink = (output_sink_t *)calloc(1, sizeof(output_sink_t));
+    size_t capacity = OUTPUT_SINK_MAX_RECORD;
+
+    if (sink == NULL) {
+        return NULL;
+    }
+
+    if (buffer_size == 0) {
+        buffer_size = OUTPUT_SINK_DEFAULT_BUFFER_SIZE;
+    }
+
+    while (capacity < buffer_size) {
+        capacity *= 2;
+    }
+
+    sink->id = fetch_add(&last_sink_id, 1) + 1;
+    sink->format = format;
+    sink->symbol_name = symbol_name;
+    sink->capacity = capacity;
+
+    if (file_name == NULL) {
+        // The records written by printf() so far go first.
+        fflush(stdout);
+        sink->fd = OUTPUT_SINK_STDOUT;
+#ifdef _WIN32
+        _setmode(OUTPUT_SINK_STDOUT, format == OUTPUT_SINK_FORMAT_BINARY ? _O_BINARY : _O_TEXT);
+#endif
+    } else {
+        sink->fd = open_file(file_name);
+        sink->owns_fd = 1;
+    }
+
+    if (sink->fd < 0 || !start_writer(sink)) {
+        if (sink->owns_fd && sink->fd >= 0) {
+            close_file(sink->fd);
+        }
+
+        free(sink);
+
+        return NULL;
+    }
+
+    return sink;
+}
+
+void output_sink_write_events(output_sink_t *sink, dsp_event_t **events, size_t size) {
+    output_sink_lane_t *lane = get_lane(sink);
+    uint64_t dropped = 0;
+    uint64_t written = 0;
+
+    if (lane == NULL) {
+        for (size_t i = 0; i < size; i++) {
+            dropped += events[i]->type == DSP_ET_QUOTE || events[i]->type == DSP_ET_TRADE;
+        }
+
+        fetch_add(&sink->dropped, dropped);
+
+        return;
+    }
+
+    uint64_t head = load_acquire(&lane->head);
+    uint64_t tail = lane->tail;
+
+    for (size_t i = 0; i < size; i++) {
+        const dsp_event_t *event = events[i];
+        char record[OUTPUT_SINK_MAX_RECORD];
+        size_t length = 0;
+
+        if (event->type != DSP_ET_QUOTE && event->type != DSP_ET_TRADE) {
+            continue;
+        }
+
+        length = sink->format == OUTPUT_SINK_FORMAT_TEXT ? format_text(sink, event, record)
+                                                         : format_binary(sink, lane, event, record);
+
+        if (tail + length - head > sink->capacity) {
+            head = load_acquire(&lane->head);
+
+            if (tail + length - head > sink->capacity) {
+                dropped++;
+
+                continue;
+            }
+        }
+
+        size_t start = (size_t)(tail & (sink->capacity - 1));
+        size_t first = length < sink->capacity - start ? length : sink->capacity - start;
+
+        memcpy(lane->buffer + start, record, first);
+        memcpy(lane->buffer, record + first, length - first);
+        tail += length;
+        written++;
+
+        if (sink->format == OUTPUT_SINK_FORMAT_BINARY) {
+            define_symbol(lane, event->symbol_id);
+        }
+    }
+
+    store_release(&lane->tail, tail);
+
+    if (dropped != 0) {
+        fetch_add(&sink->dropped, dropped);
+    }
+
+    fetch_add(&sink->written, written);
+}
+
+uint64_t output_sink_get_dropped_count(const output_sink_t *sink) {
+    return load_acquire((volatile uint64_t *)&sink->dropped);
+}
+
+uint64_t output_sink_get_written_count(const output_sink_t *sink) {
+    return load_acquire((volatile uint64_t *)&sink->written);
+}
+
+void output_sink_close(output_sink_t *sink) {
+    if (sink == NULL) {
+        return;
+    }
+
+    store_release(&sink->stopped, 1);
+    join_writer(sink);
+
+    if (sink->owns_fd) {
+        close_file(sink->fd);
+    }
+
+    for (size_t i = 0; i < OUTPUT_SINK_MAX_LANES; i++) {
+        free(sink->lanes[i].buffer);
+        free(sink->lanes[i].defined_symbols);
+    }
+
+    free(sink);
+}
@@ -0,0 +1,77 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <plugin-api.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+// The asynchronous output of the events: the listeners append the formatted records to the per-thread buffers
+// (lock-free, without I/O) and the writer thread of the sink flushes them to the output by large writes. When a buffer
+// is full (the output can't keep up) the records are dropped and counted instead of stalling the feed.
+//
+// The records of one thread are written in order; the records of the different threads are interleaved by batches.
+
+typedef enum output_sink_format_t {
+    // The lines `Quote{AAPL, bid_price = 123.45, ...}`, the doubles are formatted by the shortest representation that
+    // parses back to the same value.
+    OUTPUT_SINK_FORMAT_TEXT,
+
+    // The records of the output_sink_record_header_t and the doubles of the event in the native byte order.
+    OUTPUT_SINK_FORMAT_BINARY,
+} output_sink_format_t;
+
+// The type of the binary record that defines the name of a symbol id: the header is followed by the name (without the
+// terminating zero). Every thread defines a symbol before its first event.
+#define OUTPUT_SINK_RECORD_SYMBOL 0xFFFF
+
+// The header of a binary record. The header of an event (type is dsp_event_type_t) is followed by the doubles:
+// bid_price, bid_size, ask_price, ask_size of a quote or price, size, dayVolume of a trade.
+typedef struct output_sink_record_header_t {
+    uint16_t size; // The size of the record including the header
+    uint16_t type;
+    uint32_t symbol_id;
+} output_sink_record_header_t;
+
+DSP_STATIC_ASSERT(sizeof(output_sink_record_header_t) == 8, "output_sink_record_header_t must be 8 bytes");
+
+typedef struct output_sink_t output_sink_t;
+
+// Returns the name of the symbol id (dsp_symbol_name).
+typedef const char *(*output_sink_symbol_name_fn_t)(uint32_t);
+
+// Opens the sink and starts its writer thread.
+//
+// file_name   - the file to write to (truncated), NULL for the standard output
+// format      - the format of the records
+// buffer_size - the size of the buffer of every thread in bytes (rounded up to a power of two), 0 for the default
+// symbol_name - resolves the symbol ids of the events
+//
+// Returns the sink or NULL if the file can't be opened.
+output_sink_t *output_sink_open(const char *file_name, output_sink_format_t format, size_t buffer_size,
+                                output_sink_symbol_name_fn_t symbol_name);
+
+// Appends the quotes and trades of the batch (the other events are skipped). Doesn't block. Thread-safe: every thread
+// gets its own buffer on the first call.
+void output_sink_write_events(output_sink_t *sink, dsp_event_t **events, size_t size);
+
+// Returns the number of the events dropped so far because the buffer was full (or there were too many threads).
+uint64_t output_sink_get_dropped_count(const output_sink_t *sink);
+
+// Returns the number of the events written so far.
+uint64_t output_sink_get_written_count(const output_sink_t *sink);
+
+// Stops the writer thread after it flushes the buffers, closes the file and frees the sink. Must not be called while
+// output_sink_write_events() is running.
+void output_sink_close(output_sink_t *sink);
+
+// Formats the double by the shortest representation that parses back (strtod) to the same value. Exact decimals (the
+// prices and sizes) are formatted without printf.
+//
+// value  - the value
+// buffer - at least 32 chars
+//
+// Returns the length (the buffer is not zero-terminated).
+size_t output_sink_format_double(double value, char *buffer);
@@ -0,0 +1,285 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#include "Test.hpp"
+
+#include <plugin-api.h>
+
+// The allocation counter of the benchmarks (the replaced global operator new).
+#include "Bench.hpp"
+
+#include "EventQueue.hpp"
+#include "Histogram.hpp"
+#include "Pipeline.hpp"
+#include "Router.hpp"
+#include "SnapshotTable.hpp"
+#include "Subscriber.hpp"
+#include "SymbolTable.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dsp::test {
+
+namespace {
+
+constexpr std::size_t SYMBOLS = 64;
+constexpr std::size_t BATCH_SIZE = 256;
+constexpr std::size_t WARM_UP_DELIVERIES = 64;
+constexpr std::size_t DELIVERIES = 1024;
+
+// The shape of the events of the C++ API: the polymorphic objects delivered by a subscription as a vector of
+// shared_ptr to the base class.
+class EventObject {
+    std::string eventSymbol_;
+    std::int64_t eventTime_;
+
+  public:
+    EventObject(std::string eventSymbol, std::int64_t eventTime)
+        : eventSymbol_{std::move(eventSymbol)}, eventTime_{eventTime} {
+    }
+
+    virtual ~EventObject() = default;
+
+    const std::string &getEventSymbol() const noexcept {
+        return eventSymbol_;
+    }
+
+    std::int64_t getEventTime() const noexcept {
+        return eventTime_;
+    }
+};
+
+class QuoteObject final : public EventObject {
+    double bidPrice_;
+    double bidSize_;
+    double askPrice_;
+    double askSize_;
+
+  public:
+    QuoteObject(std::string eventSymbol, std::int64_t eventTime, double bidPrice, double bidSize, double askPrice,
+                double askSize)
+        : EventObject{std::move(eventSymbol), eventTime}, bidPrice_{bidPrice}, bidSize_{bidSize}, askPrice_{askPrice},
+          askSize_{askSize} {
+    }
+
+    double getBidPrice() const noexcept {
+        return bidPrice_;
+    }
+
+    double getBidSize() const noexcept {
+        return bidSize_;
+    }
+
+    double getAskPrice() const noexcept {
+        return askPrice_;
+    }
+
+    double getAskSize() const noexcept {
+        return askSize_;
+    }
+};
+
+class TradeObject final : public EventObject {
+    double price_;
+    double size_;
+    double dayVolume_;
+
+  public:
+    TradeObject(std::string eventSymbol, std::int64_t eventTime, double price, double size, double dayVolume)
+        : EventObject{std::move(eventSymbol), eventTime}, price_{price}, size_{size}, dayVolume_{dayVolume} {
+    }
+
+    double getPrice() const noexcept {
+        return price_;
+    }
+
+    double getSize() const noexcept {
+        return size_;
+    }
+
+    double getDayVolume() const noexcept {
+        return dayVolume_;
+    }
+};
+
+using Events = std::vector<std::shared_ptr<EventObject>>;
+
+void marshal(const QuoteObject &q, std::uint32_t symbolId, dsp_event_record_t &record) noexcept {
+    record.quote = dsp_quote_t{{sizeof(dsp_quote_t), DSP_ET_QUOTE, symbolId, 0},
+                               q.getBidPrice(),
+                               q.getBidSize(),
+                               q.getAskPrice(),
+                               q.getAskSize()};
+}
+
+void marshal(const TradeObject &tr, std::uint32_t symbolId, dsp_event_record_t &record) noexcept {
+    record.trade = dsp_trade_t{
+        {sizeof(dsp_trade_t), DSP_ET_TRADE, symbolId, 0}, tr.getPrice(), tr.getSize(), tr.getDayVolume()};
+}
+
+std::int64_t currentTimeMillis() noexcept {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+// The listener of the subscription to E, as in the plugin: the records are written in place, the symbols are interned
+// by runs and the lags are recorded.
+template <typename E>
+std::size_t marshal(const Events &events, SymbolTable &symbols, dsp_event_record_t *records, Histogram &lags) {
+    SymbolTable::RunCache symbolIds{symbols};
+    auto now = currentTimeMillis();
+    std::size_t size = 0;
+
+    for (const auto &e : events) {
+        const auto &event = static_cast<const E &>(*e);
+
+        marshal(event, symbolIds.intern(event.getEventSymbol()), records[size++]);
+        lags.recordSingleWriter(static_cast<std::uint64_t>(std::max<std::int64_t>(now - event.getEventTime(), 0)) *
+                                1'000'000);
+    }
+
+    return size;
+}
+
+struct Delivery {
+    Events quotes{};
+    Events trades{};
+};
+
+// The runs of the symbols, the trades of every 4th symbol.
+std::vector<Delivery> generate() {
+    std::vector<Delivery> deliveries(16);
+    auto now = currentTimeMillis();
+    std::size_t next = 0;
+
+    for (auto &delivery : deliveries) {
+        for (std::size_t i = 0; i < BATCH_SIZE; i++, next++) {
+            auto symbol = "SYM" + std::to_string(next / 3 % SYMBOLS);
+            auto price = 100.0 + static_cast<double>(next % 100) / 100;
+
+            if (next % 4 == 0) {
+                delivery.trades.push_back(std::make_shared<TradeObject>(symbol, now, price, 1.0, 10.0));
+            } else {
+                delivery.quotes.push_back(std::make_shared<QuoteObject>(symbol, now, price, 2.0, price + 0.01, 3.0));
+            }
+        }
+    }
+
+    return deliveries;
+}
+
+struct Counters {
+    std::atomic<std::uint64_t> events{};
+    std::atomic<std::uint64_t> records{};
+    std::atomic<std::uint64_t> quotes{};
+    std::atomic<std::uint64_t> trades{};
+};
+
+void countEvents(dsp_event_t ** /*events*/, size_t size, void *userData) {
+    static_cast<Counters *>(userData)->events.fetch_add(size);
+}
+
+void countRecords(const dsp_event_record_t * /*records*/, size_t size, void *userData) {
+    static_cast<Counters *>(userData)->records.fetch_add(size);
+}
+
+void countColumns(const dsp_quote_columns_t *quotes, const dsp_trade_columns_t *trades, void *userData) {
+    static_cast<Counters *>(userData)->quotes.fetch_add(quotes->count);
+    static_cast<Counters *>(userData)->trades.fetch_add(trades->count);
+}
+
+// Marshals and dispatches the synthetic deliveries to the subscribers of every kind and checks that, after the
+// warm-up, neither the marshaling, the routing nor the delivery allocates.
+void testSteadyState(std::size_t dispatchThreads) {
+    auto deliveries = generate();
+    SymbolTable symbols{};
+    Router router{};
+    SnapshotTable snapshots{};
+    Counters counters{};
+    auto queue = std::make_shared<EventQueue>(BATCH_SIZE * 4);
+    std::vector<dsp_event_record_t> polled(BATCH_SIZE * 4);
+
+    router.update([&] {
+        auto *events = router.addSubscriber(Subscriber::events(countEvents, &counters));
+        auto *records = router.addSubscriber(Subscriber::records(countRecords, &counters));
+        auto *columns = router.addSubscriber(Subscriber::columns(countColumns, &counters));
+        auto *queued = router.addSubscriber(Subscriber::queue(queue));
+        auto *snapshot = router.addSubscriber(Subscriber::events(nullptr, nullptr));
+
+        for (std::size_t i = 0; i < SYMBOLS; i++) {
+            auto symbolId = symbols.intern("SYM" + std::to_string(i));
+
+            router.addRoute(symbolId, events, DSP_EVENT_TYPE_MASK_DEFAULT);
+            router.addRoute(symbolId, columns, DSP_EVENT_TYPE_MASK_DEFAULT);
+            router.addRoute(symbolId, snapshot, DSP_EVENT_TYPE_MASK_DEFAULT);
+
+            // A part of the batch, so the records are copied.
+            if (i % 2 == 0) {
+                router.addRoute(symbolId, records, DSP_EVENT_TYPE_MASK_DEFAULT);
+                router.addRoute(symbolId, queued, DSP_EVENT_TYPE_MASK_DEFAULT);
+            }
+        }
+    });
+
+    Pipeline pipeline{router, snapshots};
+
+    pipeline.setDispatchThreads(dispatchThreads);
+
+    std::uint64_t expected = 0;
+    auto deliver = [&](const Delivery &delivery) {
+        pipeline.process(DSP_ET_QUOTE, delivery.quotes.size(), [&](dsp_event_record_t *records, Histogram &lags) {
+            return marshal<QuoteObject>(delivery.quotes, symbols, records, lags);
+        });
+        pipeline.process(DSP_ET_TRADE, delivery.trades.size(), [&](dsp_event_record_t *records, Histogram &lags) {
+            return marshal<TradeObject>(delivery.trades, symbols, records, lags);
+        });
+        expected += delivery.quotes.size() + delivery.trades.size();
+
+        // One batch at a time, so the pool of batches does not grow after the warm-up.
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+        while (counters.events.load() != expected && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+
+        while (queue->poll(polled.data(), polled.size()) != 0) {
+        }
+    };
+
+    for (std::size_t i = 0; i < WARM_UP_DELIVERIES; i++) {
+        deliver(deliveries[i % deliveries.size()]);
+    }
+
+    auto allocations = bench::getAllocationCount();
+
+    for (std::size_t i = 0; i < DELIVERIES; i++) {
+        deliver(deliveries[i % deliveries.size()]);
+    }
+
+    DSP_CHECK(bench::getAllocationCount() - allocations == 0);
+    DSP_CHECK(counters.events.load() == expected);
+    DSP_CHECK(expected == (WARM_UP_DELIVERIES + DELIVERIES) * BATCH_SIZE);
+    DSP_CHECK(counters.quotes.load() + counters.trades.load() == counters.events.load());
+    DSP_CHECK(counters.records.load() != 0 && counters.records.load() < counters.events.load());
+    DSP_CHECK(queue->getOverflowCount() == 0);
+
+    dsp_quote_t quote{};
+
+    DSP_CHECK(snapshots.readQuote(symbols.find("SYM1"), quote) && quote.bid_price >= 100.0);
+}
+
+} // namespace
+
+void runAllocationTests() {
+    testSteadyState(0);
+    testSteadyState(1);
+}
+
+} // namespace dsp::test
@@ -0,0 +1,87 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#include "Test.hpp"
+
+#include "Histogram.hpp"
+#include "Probe.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace dsp::test {
+
+namespace {
+
+std::uint64_t countOf(ProbeSite &site) {
+    Histogram histogram{};
+
+    site.collect(histogram);
+
+    return histogram.getCount();
+}
+
+// The slot of a destroyed site is reused: the sites created one after another never run out of slots, and a thread
+// that recorded into the previous owner of the slot records into the new one.
+void testRecyclesSlots() {
+    for (std::size_t i = 0; i < 4 * ProbeSite::MAX_SITES; i++) {
+        ProbeSite site{"recycled"};
+
+        site.record(1000);
+        site.local().recordSingleWriter(2000);
+
+        DSP_CHECK(countOf(site) == 2);
+    }
+}
+
+// The sites created while all the slots are taken don't record, and the threads recording into them don't share
+// anything.
+void testDropsRecordsOfExtraSites() {
+    static constexpr std::size_t RECORDS = 10000;
+
+    std::vector<std::unique_ptr<ProbeSite>> sites{};
+
+    for (std::size_t i = 0; i <= ProbeSite::MAX_SITES; i++) {
+        sites.push_back(std::make_unique<ProbeSite>("extra"));
+    }
+
+    auto &first = *sites.front();
+    auto &last = *sites.back();
+    std::vector<std::thread> threads{};
+
+    for (std::size_t t = 0; t < 2; t++) {
+        threads.emplace_back([&] {
+            for (std::size_t i = 0; i < RECORDS; i++) {
+                first.record(100);
+                last.record(100);
+                last.local().recordSingleWriter(100);
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    DSP_CHECK(countOf(first) == 2 * RECORDS);
+    DSP_CHECK(countOf(last) == 0);
+
+    sites.front().reset();
+
+    ProbeSite next{"next"};
+
+    next.record(100);
+
+    DSP_CHECK(countOf(next) == 1);
+}
+
+} // namespace
+
+void runProbeTests() {
+    testRecyclesSlots();
+    testDropsRecordsOfExtraSites();
+}
+
+} // namespace dsp::test
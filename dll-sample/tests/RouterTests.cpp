@@ -0,0 +1,252 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#include "Test.hpp"
+
+#include <plugin-api.h>
+
+#include "Router.hpp"
+#include "Subscriber.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace dsp::test {
+
+namespace {
+
+// The symbol id and the event type of every delivered record.
+using Received = std::vector<std::pair<std::uint32_t, std::uint32_t>>;
+
+void receive(const dsp_event_record_t *records, size_t size, void *userData) {
+    for (std::size_t i = 0; i < size; i++) {
+        static_cast<Received *>(userData)->emplace_back(records[i].event.symbol_id, records[i].event.type);
+    }
+}
+
+dsp_event_record_t quote(std::uint32_t symbolId) {
+    dsp_event_record_t record{};
+
+    record.quote = dsp_quote_t{{sizeof(dsp_quote_t), DSP_ET_QUOTE, symbolId, 0}, 1.0, 2.0, 3.0, 4.0};
+
+    return record;
+}
+
+dsp_event_record_t trade(std::uint32_t symbolId) {
+    dsp_event_record_t record{};
+
+    record.trade = dsp_trade_t{{sizeof(dsp_trade_t), DSP_ET_TRADE, symbolId, 0}, 1.0, 2.0, 3.0};
+
+    return record;
+}
+
+constexpr auto QUOTES = DSP_EVENT_TYPE_MASK(DSP_ET_QUOTE);
+constexpr auto TRADES = DSP_EVENT_TYPE_MASK(DSP_ET_TRADE);
+
+// Every subscriber receives only the records of its symbols and event types, in the order of the batch.
+void testRoutesBySymbolAndType() {
+    Router router{};
+    Received a{};
+    Received b{};
+    auto *subscriberA = router.addSubscriber(Subscriber::records(receive, &a));
+    auto *subscriberB = router.addSubscriber(Subscriber::records(receive, &b));
+
+    router.update([&] {
+        router.addRoute(1, subscriberA, QUOTES);
+        router.addRoute(1, subscriberB, QUOTES | TRADES);
+        router.addRoute(2, subscriberB, TRADES);
+    });
+
+    std::vector<dsp_event_record_t> batch{quote(1), trade(1), quote(2), trade(2), quote(3), trade(3), quote(1)};
+
+    router.dispatch(batch.data(), batch.size());
+
+    DSP_CHECK((a == Received{{1, DSP_ET_QUOTE}, {1, DSP_ET_QUOTE}}));
+    DSP_CHECK((b == Received{{1, DSP_ET_QUOTE}, {1, DSP_ET_TRADE}, {2, DSP_ET_TRADE}, {1, DSP_ET_QUOTE}}));
+}
+
+// The changes report the event types of a symbol that nobody subscribed to before and that nobody subscribes to
+// anymore.
+void testReportsChanges() {
+    Router router{};
+    Received a{};
+    Received b{};
+    auto *subscriberA = router.addSubscriber(Subscriber::records(receive, &a));
+    auto *subscriberB = router.addSubscriber(Subscriber::records(receive, &b));
+
+    auto change = router.addRoute(1, subscriberA, QUOTES);
+
+    DSP_CHECK(change.added == QUOTES && change.removed == 0);
+
+    change = router.addRoute(1, subscriberB, QUOTES | TRADES);
+
+    DSP_CHECK(change.added == TRADES && change.removed == 0);
+
+    change = router.removeRoute(1, subscriberA);
+
+    DSP_CHECK(change.added == 0 && change.removed == 0);
+
+    change = router.removeRoute(1, subscriberB);
+
+    DSP_CHECK(change.added == 0 && change.removed == (QUOTES | TRADES));
+
+    change = router.removeRoute(2, subscriberB);
+
+    DSP_CHECK(change.added == 0 && change.removed == 0);
+}
+
+// The same consumer is registered once.
+void testIdentifiesConsumers() {
+    Router router{};
+    Received a{};
+    auto *first = router.addSubscriber(Subscriber::records(receive, &a));
+    auto *second = router.addSubscriber(Subscriber::records(receive, &a));
+
+    DSP_CHECK(first == second);
+    DSP_CHECK(router.findSubscriber(*Subscriber::records(receive, &a)) == first);
+    DSP_CHECK(router.findSubscriber(*Subscriber::records(receive, nullptr)) == nullptr);
+    DSP_CHECK(router.findSubscriber(*Subscriber::events(nullptr, &a)) == nullptr);
+}
+
+// The symbols are replaced by their difference, only the changed symbols are reported.
+void testSetRoutes() {
+    Router router{};
+    Received a{};
+    auto *subscriber = router.addSubscriber(Subscriber::records(receive, &a));
+    std::vector<std::uint32_t> changed{};
+    auto onChange = [&changed](std::uint32_t symbolId, Router::Change) {
+        changed.push_back(symbolId);
+    };
+
+    router.setRoutes(subscriber, {1, 2, 3}, QUOTES, onChange);
+
+    DSP_CHECK((changed == std::vector<std::uint32_t>{1, 2, 3}));
+
+    changed.clear();
+    router.setRoutes(subscriber, {2, 3, 4}, QUOTES, onChange);
+
+    DSP_CHECK((changed == std::vector<std::uint32_t>{1, 4}));
+
+    auto symbolIds = router.getSymbolIds(subscriber);
+
+    std::sort(symbolIds.begin(), symbolIds.end());
+    DSP_CHECK((symbolIds == std::vector<std::uint32_t>{2, 3, 4}));
+    DSP_CHECK(router.getRoute(1, subscriber) == 0);
+    DSP_CHECK(router.getRoute(4, subscriber) == QUOTES);
+}
+
+// The changes made by an update are published at once when it ends.
+void testPublishesUpdatesAtOnce() {
+    Router router{};
+    Received a{};
+    auto *subscriber = router.addSubscriber(Subscriber::records(receive, &a));
+    std::vector<dsp_event_record_t> batch{quote(1)};
+
+    router.update([&] {
+        router.addRoute(1, subscriber, QUOTES);
+        router.dispatch(batch.data(), batch.size());
+
+        DSP_CHECK(a.empty());
+    });
+
+    router.dispatch(batch.data(), batch.size());
+
+    DSP_CHECK(a.size() == 1);
+
+    router.removeRoute(1, subscriber);
+    router.removeSubscriber(subscriber);
+    router.dispatch(batch.data(), batch.size());
+
+    DSP_CHECK(a.size() == 1);
+}
+
+// The deferred changes are published by the flush or with the next published change.
+void testDefersChanges() {
+    Router router{};
+    Received a{};
+    auto *subscriber = router.addSubscriber(Subscriber::records(receive, &a));
+    std::vector<dsp_event_record_t> batch{quote(1), quote(2)};
+
+    router.defer([&] {
+        router.addRoute(1, subscriber, QUOTES);
+    });
+    router.dispatch(batch.data(), batch.size());
+
+    DSP_CHECK(a.empty());
+
+    router.flush();
+    router.dispatch(batch.data(), batch.size());
+
+    DSP_CHECK((a == Received{{1, DSP_ET_QUOTE}}));
+
+    router.defer([&] {
+        router.addRoute(2, subscriber, QUOTES);
+    });
+    router.removeRoute(1, subscriber);
+    a.clear();
+    router.dispatch(batch.data(), batch.size());
+
+    DSP_CHECK((a == Received{{2, DSP_ET_QUOTE}}));
+}
+
+// The subscriber that is left without symbols is unregistered, but the snapshot being dispatched keeps it alive: it may
+// be removed by its own callback.
+void testRemovesUnusedSubscribers() {
+    struct Context {
+        Router *router;
+        Subscriber *subscriber;
+        std::size_t received;
+    };
+
+    Router router{};
+    Context context{&router, nullptr, 0};
+    auto unsubscribe = [](const dsp_event_record_t *, size_t size, void *userData) {
+        auto &context = *static_cast<Context *>(userData);
+
+        context.received += size;
+        context.router->update([&context] {
+            context.router->removeRoute(1, context.subscriber);
+            context.router->removeRoute(2, context.subscriber);
+            DSP_CHECK(context.router->removeSubscriberIfUnused(context.subscriber));
+        });
+    };
+
+    context.subscriber = router.addSubscriber(Subscriber::records(unsubscribe, &context));
+    router.update([&] {
+        router.addRoute(1, context.subscriber, QUOTES);
+        router.addRoute(2, context.subscriber, QUOTES);
+    });
+
+    router.removeRoute(2, context.subscriber);
+
+    DSP_CHECK(!router.removeSubscriberIfUnused(context.subscriber));
+
+    std::vector<dsp_event_record_t> batch{quote(1), quote(2), quote(1)};
+
+    router.dispatch(batch.data(), batch.size());
+    router.dispatch(batch.data(), batch.size());
+
+    DSP_CHECK(context.received == 2);
+    DSP_CHECK(router.findSubscriber(*Subscriber::records(unsubscribe, &context)) == nullptr);
+    DSP_CHECK(router.getSymbolIds(context.subscriber).empty());
+
+    auto change = router.addRoute(1, router.addSubscriber(Subscriber::records(receive, nullptr)), QUOTES);
+
+    DSP_CHECK(change.added == QUOTES);
+}
+
+} // namespace
+
+void runRouterTests() {
+    testRoutesBySymbolAndType();
+    testReportsChanges();
+    testIdentifiesConsumers();
+    testSetRoutes();
+    testPublishesUpdatesAtOnce();
+    testDefersChanges();
+    testRemovesUnusedSubscribers();
+}
+
+} // namespace dsp::test
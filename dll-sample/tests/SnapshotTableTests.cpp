@@ -0,0 +1,102 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#include "Test.hpp"
+
+#include <plugin-api.h>
+
+#include "SnapshotTable.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace dsp::test {
+
+namespace {
+
+dsp_event_record_t quote(std::uint32_t symbolId, double value) {
+    dsp_event_record_t record{};
+
+    record.quote = dsp_quote_t{{sizeof(dsp_quote_t), DSP_ET_QUOTE, symbolId, 0}, value, value, value, value};
+
+    return record;
+}
+
+// The table keeps the latest quote and trade of every symbol.
+void testKeepsLatestValues() {
+    SnapshotTable snapshots{};
+    dsp_quote_t quoteValue{};
+    dsp_trade_t tradeValue{};
+
+    DSP_CHECK(!snapshots.readQuote(1, quoteValue));
+
+    dsp_event_record_t trade{};
+
+    trade.trade = dsp_trade_t{{sizeof(dsp_trade_t), DSP_ET_TRADE, 1, 0}, 5.0, 6.0, 7.0};
+
+    std::vector<dsp_event_record_t> batch{quote(1, 1.0), quote(2, 2.0), quote(1, 3.0), trade};
+
+    snapshots.update(batch.data(), batch.size());
+
+    DSP_CHECK(snapshots.readQuote(1, quoteValue) && quoteValue.bid_price == 3.0 && quoteValue.event.symbol_id == 1);
+    DSP_CHECK(snapshots.readQuote(2, quoteValue) && quoteValue.ask_size == 2.0);
+    DSP_CHECK(snapshots.readTrade(1, tradeValue) && tradeValue.price == 5.0 && tradeValue.dayVolume == 7.0);
+    DSP_CHECK(!snapshots.readTrade(2, tradeValue));
+    DSP_CHECK(!snapshots.readQuote(3, quoteValue));
+}
+
+// The readers never see a quote that is partially written: all the fields of every written quote are equal.
+void testReadsAreConsistent() {
+    static constexpr std::size_t WRITES = 200'000;
+    static constexpr std::size_t READERS = 2;
+
+    SnapshotTable snapshots{};
+    std::atomic<bool> writing{true};
+    std::atomic<std::size_t> torn{};
+    std::vector<std::thread> readers{};
+    auto first = quote(1, 0.0);
+
+    snapshots.update(&first, 1);
+
+    for (std::size_t i = 0; i < READERS; i++) {
+        readers.emplace_back([&] {
+            dsp_quote_t value{};
+
+            while (writing.load(std::memory_order_relaxed)) {
+                if (snapshots.readQuote(1, value) &&
+                    (value.bid_size != value.bid_price || value.ask_price != value.bid_price ||
+                     value.ask_size != value.bid_price)) {
+                    torn.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    for (std::size_t i = 1; i <= WRITES; i++) {
+        auto record = quote(1, static_cast<double>(i));
+
+        snapshots.update(&record, 1);
+    }
+
+    writing = false;
+
+    for (auto &reader : readers) {
+        reader.join();
+    }
+
+    dsp_quote_t last{};
+
+    DSP_CHECK(torn.load() == 0);
+    DSP_CHECK(snapshots.readQuote(1, last) && last.bid_price == static_cast<double>(WRITES));
+}
+
+} // namespace
+
+void runSnapshotTableTests() {
+    testKeepsLatestValues();
+    testReadsAreConsistent();
+}
+
+} // namespace dsp::test
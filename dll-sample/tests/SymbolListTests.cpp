@@ -0,0 +1,76 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#include "Test.hpp"
+
+#include "SymbolList.hpp"
+#include "SymbolTable.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace dsp::test {
+
+namespace {
+
+using Ids = std::vector<std::uint32_t>;
+
+// The list is the sorted unique ids of the symbols, without the `nullptr` symbols.
+void testInterns() {
+    SymbolTable symbols{};
+    auto ibm = symbols.intern("IBM");
+    auto aapl = symbols.intern("AAPL");
+    const char *const names[] = {"AAPL", nullptr, "MSFT", "IBM", "AAPL"};
+    auto list = SymbolList::intern(symbols, names, 5);
+    auto msft = symbols.find("MSFT");
+
+    DSP_CHECK(msft != SymbolTable::INVALID_ID);
+    DSP_CHECK(list.size() == 3);
+    DSP_CHECK((list.getIds() == Ids{ibm, aapl, msft}));
+    DSP_CHECK(SymbolList::intern(symbols, nullptr, 0).size() == 0);
+}
+
+struct Diff {
+    Ids removed{};
+    Ids added{};
+    Ids kept{};
+
+    bool operator==(const Diff &) const = default;
+};
+
+Diff diff(const Ids &from, const Ids &to) {
+    Diff result{};
+
+    SymbolList::diff(
+        from, to,
+        [&](std::uint32_t id) {
+            result.removed.push_back(id);
+        },
+        [&](std::uint32_t id) {
+            result.added.push_back(id);
+        },
+        [&](std::uint32_t id) {
+            result.kept.push_back(id);
+        });
+
+    return result;
+}
+
+// Every id is reported once: removed, added or kept.
+void testDiffs() {
+    DSP_CHECK((diff({}, {}) == Diff{}));
+    DSP_CHECK((diff({}, {1, 2}) == Diff{{}, {1, 2}, {}}));
+    DSP_CHECK((diff({1, 2}, {}) == Diff{{1, 2}, {}, {}}));
+    DSP_CHECK((diff({1, 2, 3}, {1, 2, 3}) == Diff{{}, {}, {1, 2, 3}}));
+    DSP_CHECK((diff({1, 3, 5, 7}, {2, 3, 6, 7, 8}) == Diff{{1, 5}, {2, 6, 8}, {3, 7}}));
+    DSP_CHECK((diff({10, 20}, {1, 2}) == Diff{{10, 20}, {1, 2}, {}}));
+}
+
+} // namespace
+
+void runSymbolListTests() {
+    testInterns();
+    testDiffs();
+}
+
+} // namespace dsp::test
@@ -0,0 +1,35 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <cstddef>
+
+namespace dsp::test {
+
+/**
+ * Records the result of a check: a failed check is printed with its location and fails the run.
+ *
+ * @param passed `true` if the check passed
+ * @param expression The checked expression
+ * @param file The file of the check
+ * @param line The line of the check
+ */
+void check(bool passed, const char *expression, const char *file, int line) noexcept;
+
+/**
+ * @return The number of the failed checks so far.
+ */
+std::size_t getFailureCount() noexcept;
+
+void runAllocationTests();
+void runRouterTests();
+void runSymbolListTests();
+void runSnapshotTableTests();
+void runTickFileTests();
+void runProbeTests();
+
+} // namespace dsp::test
+
+/// Checks the condition, the failure is reported and the test goes on.
+#define DSP_CHECK(condition) ::dsp::test::check(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
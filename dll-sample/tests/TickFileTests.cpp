@@ -0,0 +1,350 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#include "Test.hpp"
+
+#include <plugin-api.h>
+
+#include "SymbolTable.hpp"
+#include "TickFile.hpp"
+#include "TickRecorder.hpp"
+#include "TickReplay.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace dsp::test {
+
+namespace {
+
+struct Replayed {
+    const TickReplay *replay{};
+    std::vector<dsp_event_record_t> records{};
+    std::vector<std::string> symbols{};
+    std::vector<std::size_t> batchSizes{};
+};
+
+void collect(dsp_event_t **events, size_t size, void *userData) {
+    auto &replayed = *static_cast<Replayed *>(userData);
+
+    for (std::size_t i = 0; i < size; i++) {
+        dsp_event_record_t record{};
+        const auto *name = replayed.replay->getSymbolName(events[i]->symbol_id);
+
+        std::memcpy(&record, events[i], events[i]->struct_size);
+        replayed.records.push_back(record);
+        replayed.symbols.emplace_back(name == nullptr ? "<unknown>" : name);
+    }
+
+    replayed.batchSizes.push_back(size);
+}
+
+Replayed replay(const TickReplay &tickReplay) {
+    Replayed replayed{&tickReplay};
+
+    DSP_CHECK(tickReplay.replay(0, collect, &replayed) == replayed.records.size());
+
+    return replayed;
+}
+
+std::string tempFile(const char *name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+std::vector<dsp_event_record_t> batch(SymbolTable &symbols, std::size_t first, std::size_t size) {
+    std::vector<dsp_event_record_t> records(size);
+
+    for (std::size_t i = 0; i < size; i++) {
+        auto n = first + i;
+        auto symbolId = symbols.intern("SYM" + std::to_string(n % 7));
+
+        if (n % 3 == 0) {
+            records[i].trade = dsp_trade_t{{sizeof(dsp_trade_t), DSP_ET_TRADE, symbolId, 0}, 1.0 * n, 2.0, 3.0 * n};
+        } else {
+            records[i].quote =
+                dsp_quote_t{{sizeof(dsp_quote_t), DSP_ET_QUOTE, symbolId, 0}, 1.0 * n, 2.0, 3.0 * n, 4.0};
+        }
+    }
+
+    return records;
+}
+
+// The recorded batches are replayed as they were: the same batches, the same records and the same symbols. The other
+// event types are not recorded.
+void testRoundTrip() {
+    auto fileName = tempFile("dllsample-tests-round-trip.ticks");
+    SymbolTable symbols{};
+    std::vector<std::vector<dsp_event_record_t>> batches{batch(symbols, 0, 10), batch(symbols, 10, 1),
+                                                         batch(symbols, 11, 100)};
+    dsp_event_record_t candle{};
+
+    candle.candle.event = dsp_event_t{sizeof(dsp_candle_t), DSP_ET_CANDLE, 0, 0};
+    batches[1].push_back(candle);
+
+    {
+        TickRecorder recorder{symbols};
+
+        DSP_CHECK(recorder.start(fileName));
+
+        for (const auto &records : batches) {
+            recorder.record(StopWatch::now(), records.data(), records.size());
+        }
+
+        DSP_CHECK(recorder.getEventCount() == 111);
+    }
+
+    auto tickReplay = TickReplay::open(fileName);
+
+    DSP_CHECK(tickReplay != nullptr);
+
+    if (tickReplay != nullptr) {
+        auto replayed = replay(*tickReplay);
+        std::size_t next = 0;
+
+        DSP_CHECK(tickReplay->getEventCount() == 111);
+        DSP_CHECK((replayed.batchSizes == std::vector<std::size_t>{10, 1, 100}));
+
+        for (const auto &records : batches) {
+            for (const auto &record : records) {
+                if (record.event.type == DSP_ET_CANDLE || next >= replayed.records.size()) {
+                    continue;
+                }
+
+                const auto &replayedRecord = replayed.records[next];
+
+                DSP_CHECK(replayedRecord.event.type == record.event.type);
+                DSP_CHECK(replayedRecord.event.struct_size == record.event.struct_size);
+                DSP_CHECK(replayed.symbols[next] == symbols.name(record.event.symbol_id));
+
+                if (record.event.type == DSP_ET_QUOTE) {
+                    DSP_CHECK(replayedRecord.quote.bid_price == record.quote.bid_price &&
+                              replayedRecord.quote.ask_price == record.quote.ask_price);
+                } else {
+                    DSP_CHECK(replayedRecord.trade.price == record.trade.price &&
+                              replayedRecord.trade.dayVolume == record.trade.dayVolume);
+                }
+
+                next++;
+            }
+        }
+
+        DSP_CHECK(next == replayed.records.size());
+    }
+
+    tickReplay.reset();
+    std::filesystem::remove(fileName);
+}
+
+// A truncated file is replayed up to its last complete block, a file that is not a tick file is not opened.
+void testDamagedFiles() {
+    auto fileName = tempFile("dllsample-tests-damaged.ticks");
+    SymbolTable symbols{};
+
+    {
+        TickRecorder recorder{symbols};
+
+        recorder.start(fileName);
+
+        for (std::size_t i = 0; i < 4; i++) {
+            auto records = batch(symbols, i * 10, 10);
+
+            recorder.record(StopWatch::now(), records.data(), records.size());
+        }
+    }
+
+    std::filesystem::resize_file(fileName, std::filesystem::file_size(fileName) - 1);
+
+    if (auto tickReplay = TickReplay::open(fileName); tickReplay != nullptr) {
+        DSP_CHECK(tickReplay->getEventCount() == 30);
+        DSP_CHECK(replay(*tickReplay).records.size() == 30);
+    } else {
+        DSP_CHECK(tickReplay != nullptr);
+    }
+
+    if (auto *file = std::fopen(fileName.c_str(), "r+b"); file != nullptr) {
+        std::fputc('X', file);
+        std::fclose(file);
+    }
+
+    DSP_CHECK(TickReplay::open(fileName) == nullptr);
+    DSP_CHECK(TickReplay::open(tempFile("dllsample-tests-missing.ticks")) == nullptr);
+    std::filesystem::remove(fileName);
+}
+
+void patch(const std::string &fileName, std::size_t offset, std::uint32_t value) {
+    if (auto *file = std::fopen(fileName.c_str(), "r+b"); file != nullptr) {
+        std::fseek(file, static_cast<long>(offset), SEEK_SET);
+        std::fwrite(&value, sizeof(value), 1, file);
+        std::fclose(file);
+    }
+}
+
+// The symbol ids of the file are dense and checked: a file with a symbol id out of order (e.g. a hostile 0xFFFFFFFF
+// that would size the table of the names), with an event of an undefined symbol, of an unknown type or shorter than
+// the struct of its type is not opened.
+void testHostileSymbolIds() {
+    static constexpr auto SYMBOLS_OFFSET = sizeof(TickFile::Header) + sizeof(TickFile::BlockHeader);
+
+    auto fileName = tempFile("dllsample-tests-hostile.ticks");
+    SymbolTable symbols{};
+    std::size_t eventsOffset = 0;
+    // The offset of the last event in the events block.
+    std::size_t lastEventOffset = 0;
+
+    // The plugin's ids are sparse, the file's are not.
+    for (std::size_t i = 0; i < 1000; i++) {
+        symbols.intern("UNUSED" + std::to_string(i));
+    }
+
+    {
+        TickRecorder recorder{symbols};
+        auto records = batch(symbols, 0, 10);
+
+        recorder.start(fileName);
+        recorder.record(StopWatch::now(), records.data(), records.size());
+
+        for (std::size_t i = 0; i + 1 < records.size(); i++) {
+            lastEventOffset += TickFile::align(records[i].event.struct_size);
+        }
+    }
+
+    if (auto tickReplay = TickReplay::open(fileName); tickReplay != nullptr) {
+        auto replayed = replay(*tickReplay);
+
+        DSP_CHECK(replayed.records.size() == 10);
+        DSP_CHECK(!replayed.records.empty() && replayed.records[0].event.symbol_id == 0);
+        DSP_CHECK(!replayed.symbols.empty() && replayed.symbols[0] == "SYM0");
+        DSP_CHECK(tickReplay->getSymbolName(7) == nullptr);
+    } else {
+        DSP_CHECK(tickReplay != nullptr);
+    }
+
+    // The events block follows the symbols block.
+    if (auto *file = std::fopen(fileName.c_str(), "rb"); file != nullptr) {
+        TickFile::BlockHeader symbolsBlock{};
+
+        std::fseek(file, static_cast<long>(sizeof(TickFile::Header)), SEEK_SET);
+        DSP_CHECK(std::fread(&symbolsBlock, sizeof(symbolsBlock), 1, file) == 1);
+        DSP_CHECK(symbolsBlock.kind == TickFile::Kind::SYMBOLS && symbolsBlock.count == 7);
+        std::fclose(file);
+        eventsOffset = sizeof(TickFile::Header) + symbolsBlock.size + sizeof(TickFile::BlockHeader);
+    }
+
+    auto copy = tempFile("dllsample-tests-hostile-copy.ticks");
+
+    std::filesystem::copy_file(fileName, copy, std::filesystem::copy_options::overwrite_existing);
+    patch(copy, SYMBOLS_OFFSET, 0xFFFFFFFF);
+
+    DSP_CHECK(TickReplay::open(copy) == nullptr);
+
+    std::filesystem::copy_file(fileName, copy, std::filesystem::copy_options::overwrite_existing);
+    patch(copy, eventsOffset + offsetof(dsp_event_t, symbol_id), 7);
+
+    DSP_CHECK(TickReplay::open(copy) == nullptr);
+
+    // A quote shorter than dsp_quote_t would make the listener read past the event (and past the mapping, as it's the
+    // last event of the file).
+    std::filesystem::copy_file(fileName, copy, std::filesystem::copy_options::overwrite_existing);
+    patch(copy, eventsOffset + lastEventOffset + offsetof(dsp_event_t, struct_size), sizeof(dsp_event_t));
+
+    DSP_CHECK(TickReplay::open(copy) == nullptr);
+
+    std::filesystem::copy_file(fileName, copy, std::filesystem::copy_options::overwrite_existing);
+    patch(copy, eventsOffset + offsetof(dsp_event_t, type), DSP_ET_COUNT);
+
+    DSP_CHECK(TickReplay::open(copy) == nullptr);
+
+    std::filesystem::remove(copy);
+    std::filesystem::remove(fileName);
+}
+
+void damage(dsp_event_t **events, size_t size, void *) {
+    for (std::size_t i = 0; i < size; i++) {
+        events[i]->struct_size = 0;
+    }
+}
+
+// The listener may modify the replayed events (the mapping is copy-on-write): the file is not changed, and the next
+// replay skips the damaged events.
+void testModifiedEvents() {
+    auto fileName = tempFile("dllsample-tests-modified.ticks");
+    SymbolTable symbols{};
+
+    {
+        TickRecorder recorder{symbols};
+        auto records = batch(symbols, 0, 10);
+
+        recorder.start(fileName);
+        recorder.record(StopWatch::now(), records.data(), records.size());
+    }
+
+    if (auto tickReplay = TickReplay::open(fileName); tickReplay != nullptr) {
+        DSP_CHECK(tickReplay->replay(0, damage, nullptr) == 10);
+        DSP_CHECK(tickReplay->replay(0, damage, nullptr) == 0);
+    } else {
+        DSP_CHECK(tickReplay != nullptr);
+    }
+
+    if (auto tickReplay = TickReplay::open(fileName); tickReplay != nullptr) {
+        DSP_CHECK(replay(*tickReplay).records.size() == 10);
+    } else {
+        DSP_CHECK(tickReplay != nullptr);
+    }
+
+    std::filesystem::remove(fileName);
+}
+
+// The recording stops at the first failed write, and the stop reports it.
+void testWriteFailure() {
+    static constexpr const char *FULL_DEVICE = "/dev/full";
+
+    SymbolTable symbols{};
+    TickRecorder recorder{symbols};
+
+    // The platforms without the device that is always full.
+    if (!std::filesystem::exists(FULL_DEVICE) || !recorder.start(FULL_DEVICE)) {
+        return;
+    }
+
+    // More than the buffer of the writer.
+    for (std::size_t i = 0; i < 1000 && recorder.isRecording(); i++) {
+        auto records = batch(symbols, i * 100, 100);
+
+        recorder.record(StopWatch::now(), records.data(), records.size());
+    }
+
+    DSP_CHECK(!recorder.stop());
+
+    auto fileName = tempFile("dllsample-tests-after-failure.ticks");
+    auto records = batch(symbols, 0, 10);
+
+    // The next recording starts afresh.
+    DSP_CHECK(recorder.start(fileName));
+    recorder.record(StopWatch::now(), records.data(), records.size());
+    DSP_CHECK(recorder.stop());
+
+    if (auto tickReplay = TickReplay::open(fileName); tickReplay != nullptr) {
+        DSP_CHECK(tickReplay->getEventCount() == 10);
+    } else {
+        DSP_CHECK(tickReplay != nullptr);
+    }
+
+    std::filesystem::remove(fileName);
+}
+
+} // namespace
+
+void runTickFileTests() {
+    testRoundTrip();
+    testDamagedFiles();
+    testHostileSymbolIds();
+    testModifiedEvents();
+    testWriteFailure();
+}
+
+} // namespace dsp::test
@@ -0,0 +1,86 @@
+// Copyright (c) 2024 Devexperts LLC.
+// SPDX-License-Identifier: MPL-2.0
+
+#include "Test.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+std::atomic<std::size_t> failureCount{};
+
+} // namespace
+
+void dsp::test::check(bool passed, const char *expression, const char *file, int line) noexcept {
+    if (passed) {
+        return;
+    }
+
+    failureCount.fetch_add(1, std::memory_order_relaxed);
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+}
+
+std::size_t dsp::test::getFailureCount() noexcept {
+    return failureCount.load(std::memory_order_relaxed);
+}
+
+int main(int argc, char **argv) {
+    struct Suite {
+        const char *name;
+        void (*run)();
+    };
+
+    static const Suite suites[] = {
+        {"allocations", dsp::test::runAllocationTests},
+        {"router", dsp::test::runRouterTests},
+        {"symbol-list", dsp::test::runSymbolListTests},
+        {"snapshot-table", dsp::test::runSnapshotTableTests},
+        {"tick-file", dsp::test::runTickFileTests},
+        {"probes", dsp::test::runProbeTests},
+    };
+
+    if (argc == 2 && (std::strcmp("-?", argv[1]) == 0 || std::strcmp("-h", argv[1]) == 0)) {
+        std::printf("Usage: %s [<suite>...]\n"
+                    "Where:\n\n"
+                    "<suite> - the suite to run, all suites are run by default:\n",
+                    argv[0]);
+
+        for (const auto &suite : suites) {
+            std::printf("          %s\n", suite.name);
+        }
+
+        return 0;
+    }
+
+    std::vector<const char *> selectedNames(argv + 1, argv + argc);
+    std::size_t runCount = 0;
+
+    for (const auto &suite : suites) {
+        bool selected = selectedNames.empty();
+
+        for (const auto *name : selectedNames) {
+            selected = selected || std::strcmp(suite.name, name) == 0;
+        }
+
+        if (!selected) {
+            continue;
+        }
+
+        auto failures = dsp::test::getFailureCount();
+
+        suite.run();
+        runCount++;
+        std::printf("%-24s %s\n", suite.name, dsp::test::getFailureCount() == failures ? "passed" : "FAILED");
+    }
+
+    if (runCount == 0) {
+        std::fprintf(stderr, "No suites selected\n");
+
+        return 2;
+    }
+
+    return dsp::test::getFailureCount() == 0 ? 0 : 1;
+}